@@ -1,29 +1,53 @@
-#include "Serializer.h"
+#include "ASCIISerializers.h"
 #include "IStream.h"
 #include <Arduino.h> // For converting values on Arduino (e.g., String)
 #include "CommandStructures.h"
+#include "Scan.h"
+#include "NumberText.h"
+
+// Write the text in [begin, end) followed by the space separator, which the caller reserved at `end`
+static bool WriteToken(IStream &stream, char *begin, char *end, const Timeout &timeout)
+{
+    *end++ = ' ';
+    size_t len = end - begin;
+    return stream.Write(begin, len, timeout) == len;
+}
 
 // Serialize an int to ASCII format with space separation and write to the stream
 bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const int &item, const Timeout &timeout)
 {
-    char strData[16];
-    itoa(item, strData, 10); // Convert int to ASCII base 10
-    size_t len = strlen(strData);
-
-    // Add space separator after the integer
-    strData[len] = ' ';
-
-    return stream.Write(strData, len + 1, timeout) == len + 1;
+    char strData[NumberTextMaxLength + 1];
+    char *end = strData + NumberTextMaxLength;
+    return WriteToken(stream, FormatSigned(item, end), end, timeout);
 }
 
-// Deserialize an ASCII-formatted int from the stream, stopping at a space or end of data
-bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int &item, const Timeout &timeout)
+// Read a token ending at a space or newline into buffer. The delimiter is consumed but not stored.
+// Buffered streams are scanned a chunk at a time, other streams one character at a time.
+static size_t ReadToken(IStream &stream, char *buffer, size_t capacity, const Timeout &timeout)
 {
-    char buffer[16];
     size_t index = 0;
 
-    while (index < sizeof(buffer) - 1)
-    { // Reserve space for null-terminator
+    while (index < capacity)
+    {
+        const uint8_t *window;
+        size_t available = stream.Peek(window, timeout);
+        if (available > 0)
+        {
+            size_t count = available < capacity - index ? available : capacity - index;
+            const uint8_t *delimiter = FindEither(window, count, ' ', '\n');
+            if (delimiter)
+            {
+                count = delimiter - window;
+                memcpy(buffer + index, window, count);
+                stream.Consume(count + 1);
+                return index + count;
+            }
+            memcpy(buffer + index, window, count);
+            stream.Consume(count);
+            index += count;
+            continue;
+        }
+
         char ch;
         size_t bytesRead = stream.Read(&ch, 1, timeout); // Read one character at a time
 
@@ -40,9 +64,436 @@ bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int &item,
         buffer[index++] = ch; // Add character to buffer
     }
 
-    buffer[index] = '\0'; // Null-terminate the buffer
-    item = atoi(buffer);  // Convert ASCII to int
-    return index > 0;     // Return true if any data was read
+    return index;
+}
+
+// Read one number token into a null-terminated buffer. Fails on empty tokens and on tokens
+// that fill the whole buffer, which are too long to be a valid number.
+static bool ReadNumberToken(IStream &stream, char (&buffer)[32], size_t &length, const Timeout &timeout)
+{
+    length = ReadToken(stream, buffer, sizeof(buffer) - 1, timeout); // Reserve space for null-terminator
+    buffer[length] = '\0';
+    return length > 0 && length < sizeof(buffer) - 1;
+}
+
+// Read a decimal integer token into any integer type, rejecting values out of its range
+template <typename T>
+static bool ReadInteger(IStream &stream, T &item, const Timeout &timeout)
+{
+    char buffer[32];
+    size_t length;
+    return ReadNumberToken(stream, buffer, length, timeout) && ParseInteger(buffer, length, item);
+}
+
+// Deserialize an ASCII-formatted int from the stream, stopping at a space or end of data
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int &item, const Timeout &timeout)
+{
+    return ReadInteger(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const unsigned int &item, const Timeout &timeout)
+{
+    char strData[NumberTextMaxLength + 1];
+    char *end = strData + NumberTextMaxLength;
+    return WriteToken(stream, FormatUnsigned(item, end), end, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, unsigned int &item, const Timeout &timeout)
+{
+    return ReadInteger(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const int64_t &item, const Timeout &timeout)
+{
+    char strData[NumberTextMaxLength + 1];
+    char *end = strData + NumberTextMaxLength;
+    return WriteToken(stream, FormatSigned(item, end), end, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int64_t &item, const Timeout &timeout)
+{
+    return ReadInteger(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const uint64_t &item, const Timeout &timeout)
+{
+    char strData[NumberTextMaxLength + 1];
+    char *end = strData + NumberTextMaxLength;
+    return WriteToken(stream, FormatUnsigned(item, end), end, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, uint64_t &item, const Timeout &timeout)
+{
+    return ReadInteger(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const float &item, const Timeout &timeout)
+{
+    char strData[NumberTextMaxLength + 1];
+    size_t len = FormatFloat(item, strData);
+    return WriteToken(stream, strData, strData + len, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, float &item, const Timeout &timeout)
+{
+    char buffer[32];
+    size_t length;
+    return ReadNumberToken(stream, buffer, length, timeout) && ParseFloat(buffer, length, item);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const Hex &item, const Timeout &timeout)
+{
+    char strData[NumberTextMaxLength + 1];
+    char *end = strData + NumberTextMaxLength;
+    return WriteToken(stream, FormatHex(item.value, end), end, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, Hex &item, const Timeout &timeout)
+{
+    char buffer[32];
+    size_t length;
+    return ReadNumberToken(stream, buffer, length, timeout) && ParseHex(buffer, length, item.value);
+}
+
+// Format one array element followed by the space separator at `out`, returns the length written.
+// At most NumberTextMaxLength + 1 characters are written.
+template <typename T>
+static size_t FormatElement(T value, char *out)
+{
+    char text[NumberTextMaxLength];
+    char *end = text + sizeof(text);
+    char *begin = std::is_signed<T>::value ? FormatSigned(value, end) : FormatUnsigned(value, end);
+    size_t len = end - begin;
+    memcpy(out, begin, len);
+    out[len] = ' ';
+    return len + 1;
+}
+
+static size_t FormatElement(float value, char *out)
+{
+    size_t len = FormatFloat(value, out);
+    out[len] = ' ';
+    return len + 1;
+}
+
+// Arrays are formatted into a chunk that is written when full, so a long array takes
+// one stream write per chunk instead of one per element
+template <typename T>
+static bool WriteSpan(IStream &stream, const ConstSpan<T> &item, const Timeout &timeout)
+{
+    char chunk[64];
+    size_t used = FormatElement(static_cast<uint32_t>(item.size), chunk);
+    for (size_t i = 0; i < item.size; ++i)
+    {
+        if (used > sizeof(chunk) - (NumberTextMaxLength + 1))
+        {
+            if (stream.Write(chunk, used, timeout) != used)
+            {
+                return false;
+            }
+            used = 0;
+        }
+        used += FormatElement(item.data[i], chunk + used);
+    }
+    return stream.Write(chunk, used, timeout) == used;
+}
+
+template <typename T>
+static bool ParseElement(const char *text, size_t length, T &value)
+{
+    return ParseInteger(text, length, value);
+}
+
+static bool ParseElement(const char *text, size_t length, float &value)
+{
+    return ParseFloat(text, length, value);
+}
+
+template <typename T>
+static bool ReadSpan(IStream &stream, SpanBuffer<T> &item, const Timeout &timeout)
+{
+    size_t size;
+    if (!ReadInteger(stream, size, timeout))
+    {
+        return false;
+    }
+    if (size > item.capacity)
+    {
+        item.size = size;
+        return false; // Array does not fit the caller's buffer
+    }
+    item.size = size;
+    for (size_t i = 0; i < size; ++i)
+    {
+        char buffer[32];
+        size_t length;
+        if (!ReadNumberToken(stream, buffer, length, timeout) || !ParseElement(buffer, length, item.data[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Byte spans are arrays of decimal bytes, like the other arrays
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstByteSpan &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, blobs are deserialized into a ByteBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstByteSpan &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ByteBuffer &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstByteSpan{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ByteBuffer &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, arrays are deserialized into a SpanBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int16_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<int16_t>{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int16_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, arrays are deserialized into a SpanBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint16_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<uint16_t>{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint16_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, arrays are deserialized into a SpanBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int32_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<int32_t>{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int32_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, arrays are deserialized into a SpanBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint32_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<uint32_t>{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint32_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<float> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, arrays are deserialized into a SpanBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<float> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<float> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<float>{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<float> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+// Strings are written in double quotes followed by the space separator, so they may hold spaces.
+// Quotes and backslashes are escaped with a backslash, newlines as \n to keep the frame on one line.
+static bool WriteText(IStream &stream, const ConstText &item, const Timeout &timeout)
+{
+    char chunk[64];
+    size_t used = 0;
+    chunk[used++] = '"';
+    for (size_t i = 0; i < item.size; ++i)
+    {
+        if (used > sizeof(chunk) - 2)
+        {
+            if (stream.Write(chunk, used, timeout) != used)
+            {
+                return false;
+            }
+            used = 0;
+        }
+        char ch = item.data[i];
+        if (ch == '"' || ch == '\\' || ch == '\n')
+        {
+            chunk[used++] = '\\';
+            ch = ch == '\n' ? 'n' : ch;
+        }
+        chunk[used++] = ch;
+    }
+    if (used > sizeof(chunk) - 2)
+    {
+        if (stream.Write(chunk, used, timeout) != used)
+        {
+            return false;
+        }
+        used = 0;
+    }
+    chunk[used++] = '"';
+    chunk[used++] = ' ';
+    return stream.Write(chunk, used, timeout) == used;
+}
+
+static bool ReadChar(IStream &stream, char &ch, const Timeout &timeout)
+{
+    return stream.Read(&ch, 1, timeout) == 1;
+}
+
+// Unescaped runs are copied a chunk at a time from buffered streams. The separator after the
+// closing quote is optional, as the framing may already have consumed the end of the line.
+static bool ReadText(IStream &stream, TextBuffer &item, const Timeout &timeout)
+{
+    char ch;
+    if (!ReadChar(stream, ch, timeout) || ch != '"')
+    {
+        return false;
+    }
+    size_t size = 0;
+    while (true)
+    {
+        const uint8_t *window;
+        size_t available = stream.Peek(window, timeout);
+        if (available > 0)
+        {
+            const uint8_t *special = FindEither(window, available, '"', '\\');
+            size_t count = special ? special - window : available;
+            if (count > item.capacity - size)
+            {
+                item.size = item.capacity + 1;
+                return false; // String does not fit the caller's buffer
+            }
+            memcpy(item.data + size, window, count);
+            stream.Consume(count);
+            size += count;
+            if (!special)
+            {
+                continue;
+            }
+        }
+
+        if (!ReadChar(stream, ch, timeout))
+        {
+            return false; // Unterminated string
+        }
+        if (ch == '"')
+        {
+            break;
+        }
+        if (ch == '\\')
+        {
+            if (!ReadChar(stream, ch, timeout))
+            {
+                return false;
+            }
+            ch = ch == 'n' ? '\n' : ch;
+        }
+        if (size == item.capacity)
+        {
+            item.size = item.capacity + 1;
+            return false;
+        }
+        item.data[size++] = ch;
+    }
+    item.size = size;
+
+    const uint8_t *window;
+    if (stream.Peek(window, timeout) > 0)
+    {
+        if (window[0] != ' ' && window[0] != '\n')
+        {
+            return false;
+        }
+        stream.Consume(1);
+        return true;
+    }
+    return !ReadChar(stream, ch, timeout) || ch == ' ' || ch == '\n';
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstText &item, const Timeout &timeout)
+{
+    return WriteText(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, strings are deserialized into a TextBuffer
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstText &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const TextBuffer &item, const Timeout &timeout)
+{
+    return WriteText(stream, ConstText{item.data, item.size}, timeout);
+}
+
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, TextBuffer &item, const Timeout &timeout)
+{
+    return ReadText(stream, item, timeout);
 }
 
 bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const CommandRequest &item, const Timeout &timeout)
@@ -50,53 +501,78 @@ bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const Comman
     return serializer.Serialize(stream, (int)item.cmd, timeout);
 }
 
+// Command codes are accepted as unsigned or, for codes typed by hand, as negative ints:
+// the built-in 0xFFFFFF00 may be written as 4294967040 or -256
 bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, CommandRequest &item, const Timeout &timeout)
 {
-    int val;
-    bool success = serializer.Deserialize(stream, val, timeout);
+    int64_t val;
+    if (!ReadInteger(stream, val, timeout) || val < INT32_MIN || val > UINT32_MAX)
+    {
+        return false;
+    }
     item.cmd = (uint32_t)val;
-    return success;
+    item.id = 0; // The ASCII format has no request ids, responses follow the request order
+    return true;
 }
 
-bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const CommandResult &item, const Timeout &timeout)
+// Request ids are not part of the ASCII format, the header is empty
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ResponseHeader &item, const Timeout &timeout)
 {
-    switch (item.resultCode)
-    {
-    case CommandResultCodes::Ok:
-        return stream.Write("Ok", 3, timeout) == 3;
-
-    case CommandResultCodes::GeneralError:
-        return stream.Write("GeneralError", 13, timeout) == 13;
+    return true;
+}
 
-    case CommandResultCodes::SerializeError:
-        return stream.Write("SerializeError", 15, timeout) == 15;
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ResponseHeader &item, const Timeout &timeout)
+{
+    item.id = 0;
+    return true;
+}
 
-    case CommandResultCodes::CommandNotFound:
-        return stream.Write("CommandNotFound", 16, timeout) == 16;
+// Results are written by name, codes without a name as their number
+static const char *const ResultNames[] = {
+    "Ok", "GeneralError", "SerializeError", "CommandNotFound", "Pending", "Busy", "JobNotFound", "Streaming"};
+static const int ResultNameCount = sizeof(ResultNames) / sizeof(ResultNames[0]);
 
-    default:
-        return serializer.Serialize(stream, (int)item.resultCode, timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const CommandResult &item, const Timeout &timeout)
+{
+    int code = (int)item.resultCode;
+    if (code < 0 || code >= ResultNameCount)
+    {
+        return serializer.Serialize(stream, code, timeout);
     }
+    char text[20];
+    size_t length = strlen(ResultNames[code]);
+    memcpy(text, ResultNames[code], length);
+    return WriteToken(stream, text, text + length, timeout);
 }
 
+// Accepts the names written above as well as plain numbers
 bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, CommandResult &item, const Timeout &timeout)
 {
+    char buffer[32];
+    size_t length;
+    if (!ReadNumberToken(stream, buffer, length, timeout))
+    {
+        return false;
+    }
+    for (int code = 0; code < ResultNameCount; code++)
+    {
+        if (strcmp(buffer, ResultNames[code]) == 0)
+        {
+            item.resultCode = (CommandResultCodes)code;
+            return true;
+        }
+    }
     int val;
-    bool success = serializer.Deserialize(stream, val, timeout);
+    if (!ParseInteger(buffer, length, val))
+    {
+        return false;
+    }
     item.resultCode = (CommandResultCodes)val;
-    return success;
+    return true;
 }
 
-// Define the array of SerializeItem for JSON serialization
-static const SerializeItem asciiSerializers[] = {
-    SERIALIZER_ENTRY(int, ASCII_Serialize, ASCII_Deserialize),
-    SERIALIZER_ENTRY(CommandRequest, ASCII_Serialize, ASCII_Deserialize),
-    SERIALIZER_ENTRY(CommandResult, ASCII_Serialize, ASCII_Deserialize),
-    // Add more types here using the same pattern
-};
-
-// Static method to create the JSON serializer
+// Static method to create the ASCII serializer
 Serializer SerializerFactory::CreateAsciiSerializer()
 {
-    return Serializer(asciiSerializers, sizeof(asciiSerializers) / sizeof(asciiSerializers[0]));
+    return Serializer(AsciiSerializerTable);
 }
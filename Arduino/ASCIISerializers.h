@@ -0,0 +1,87 @@
+#pragma once
+#include "Serializer.h"
+
+// Human readable format: values are written as text separated by spaces.
+// Numbers are decimal, Hex values "0x..." and floats use up to 9 significant digits.
+// Reading fails on malformed numbers and on values out of range of the target type.
+// Arrays are written as the element count followed by the elements.
+
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const int &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const unsigned int &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, unsigned int &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const int64_t &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, int64_t &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const uint64_t &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, uint64_t &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const float &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, float &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const Hex &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, Hex &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstByteSpan &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstByteSpan &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ByteBuffer &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ByteBuffer &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int16_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int16_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int16_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int16_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint16_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint16_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint16_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint16_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int32_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int32_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int32_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int32_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint32_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint32_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint32_t> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint32_t> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<float> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<float> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<float> &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<float> &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ConstText &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ConstText &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const TextBuffer &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, TextBuffer &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const CommandRequest &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, CommandRequest &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const ResponseHeader &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, ResponseHeader &item, const Timeout &timeout);
+bool ASCII_Serialize(const Serializer &serializer, IStream &stream, const CommandResult &item, const Timeout &timeout);
+bool ASCII_Deserialize(const Serializer &serializer, IStream &stream, CommandResult &item, const Timeout &timeout);
+
+// Define the ASCII format table
+constexpr SerializerEntry asciiSerializerEntries[] = {
+    SERIALIZER_ENTRY(int, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(unsigned int, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(int64_t, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(uint64_t, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(float, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(Hex, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstByteSpan, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ByteBuffer, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<int16_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<int16_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<uint16_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<uint16_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<int32_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<int32_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<uint32_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<uint32_t>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<float>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<float>, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ConstText, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(TextBuffer, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(CommandRequest, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(CommandResult, ASCII_Serialize, ASCII_Deserialize),
+    SERIALIZER_ENTRY(ResponseHeader, ASCII_Serialize, ASCII_Deserialize),
+    // Add more types here using the same pattern
+};
+
+inline constexpr SerializerTable AsciiSerializerTable = MakeSerializerTable(asciiSerializerEntries);
+
+// Serializer with the ASCII format resolved at compile time
+using AsciiSerializer = StaticSerializer<AsciiSerializerTable>;
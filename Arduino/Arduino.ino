@@ -1,8 +1,12 @@
 #include "CommandList.h"
+#include "TypedCommand.h"
 #include "SerialStream.h"
-#include "CommandExecutor.h"
+#include "BufferedStream.h"
+#include "StaticCommandExecutor.h"
 #include "NewLineFraming.h"
-#include "Serializer.h"
+#include "CobsFraming.h"
+#include "ASCIISerializers.h"
+#include "BinarySerializers.h"
 
 // Sample Command Function
 CommandResultCodes TestCommand(ObjectStream &objStream)
@@ -12,9 +16,101 @@ CommandResultCodes TestCommand(ObjectStream &objStream)
     return Ok;
 }
 
+// Sample typed command: reads an analog pin and scales the reading. Command<> below generates
+// the argument reads, the output write and the error handling, and describes it to clients.
+float ReadScaled(int pin, float scale)
+{
+    return analogRead(pin) * scale;
+}
+
+// Sample typed command with a string argument, e.g. `4 "hello world"` in ASCII. The string is read
+// into the arena enabled in setup() and stays valid until the end of the Tick.
+const char *Echo(const char *text)
+{
+    return text;
+}
+
+// Sample asynchronous command: averages 200 readings of A0, one per millisecond.
+// It answers at once with a job handle; the average follows when the job finishes.
+CommandResultCodes SweepJob(JobContext &job, ObjectStream &objStream)
+{
+    struct Sweep
+    {
+        uint32_t lastMs;
+        int32_t sum;
+        int16_t samples;
+    };
+    Sweep &sweep = job.State<Sweep>();
+
+    switch (job.phase)
+    {
+    case JobPhase::Start:
+        sweep.lastMs = millis();
+        return Pending;
+
+    case JobPhase::Run:
+        if (millis() == sweep.lastMs)
+            return Pending; // Not yet time for the next reading
+        sweep.lastMs = millis();
+        sweep.sum += analogRead(A0);
+        return ++sweep.samples < 200 ? Pending : Ok;
+
+    case JobPhase::Report:
+        objStream.Write(static_cast<int>(sweep.sum / sweep.samples), Timeout::Milliseconds(100));
+        return Ok;
+
+    default:
+        break; // Not a stream, never called for chunks
+    }
+    return GeneralError;
+}
+
+// Sample streaming command: sends chunks of 16 readings of A0 for as long as the client keeps
+// granting credits with BuiltinStreamCredit, and stops when it sends BuiltinJobCancel.
+// The first argument is the number of chunks granted up front.
+CommandResultCodes TelemetryStream(JobContext &job, ObjectStream &objStream)
+{
+    switch (job.phase)
+    {
+    case JobPhase::Start:
+    {
+        int credits;
+        if (!objStream.Read(credits, Timeout::Milliseconds(100)) || credits < 0)
+            return SerializeError;
+        job.AddCredits(credits);
+        return Streaming;
+    }
+
+    case JobPhase::Run:
+        return Streaming; // Readings are taken when the chunk is sent, one is always ready
+
+    case JobPhase::Chunk:
+    {
+        uint16_t samples[16];
+        for (uint16_t &sample : samples)
+            sample = analogRead(A0);
+        objStream.WriteArray(samples, 16, Timeout::Milliseconds(100));
+        return Streaming;
+    }
+
+    case JobPhase::Report:
+        return Ok;
+    }
+    return GeneralError;
+}
+
+// Wire protocol selection:
+// 0 = newline framed ASCII, for typing commands in a serial monitor
+// 1 = COBS framed binary with CRC, for host tools
+#define USE_BINARY_PROTOCOL 0
+
 // Command lookup table
 constexpr CommandLookupItem command_lookup[] = {
     {0, TestCommand},
+    {1, nullptr, SweepJob},
+    {2, nullptr, TelemetryStream},
+    Command<3, ReadScaled>(),
+    Command<4, Echo>(),
     // Add more commands here as needed
 };
 
@@ -22,16 +118,31 @@ constexpr CommandLookupItem command_lookup[] = {
 
 
 
-SerialStream stream;
-Serializer serializer = SerializerFactory::CreateAsciiSerializer();
-StaticCommandList commandList(command_lookup, sizeof(command_lookup) / sizeof(command_lookup[0]));
+SerialStream serialStream;
+BufferedStream<64> stream(serialStream);
+constexpr auto commandList = MakeCommandList(command_lookup);
 
-FramingFactory framingFactory = [](IStream &stream, std::function<void(Framing &)> callback) {
-    NewLineFraming framing(stream);
-    callback(framing);
-};
+// The executor is built at compile time: the framing is constructed in place for each frame,
+// without std::function or heap use
+#if USE_BINARY_PROTOCOL
+uint8_t rxFrame[128];
+uint8_t txFrame[128];
+BinarySerializer serializer;
+auto executor = MakeCommandExecutor<CobsFraming>(stream, commandList, serializer,
+                                                 rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+#else
+AsciiSerializer serializer;
+auto executor = MakeCommandExecutor<NewLineFraming>(stream, commandList, serializer);
+#endif
 
-CommandExecutor executor(stream, commandList, framingFactory, serializer);
+// Collects partially received frames, so loop() never waits for the sender
+uint8_t frameBuffer[128];
+
+// Room for two jobs running at once; their results are pushed when they finish
+StaticJobTable<2> jobs;
+
+// Holds the strings and arrays read by the commands of a frame, reset after every Tick
+StaticArena<64> arena;
 
 void setup()
 {
@@ -40,9 +151,17 @@ void setup()
 
     // Wait for Serial connection (helpful if using Serial Monitor)
     while (!Serial);
+
+    executor.EnableJobs(jobs);
+    executor.EnableArena(arena);
+#if USE_BINARY_PROTOCOL
+    executor.EnableNonBlocking(frameBuffer, sizeof(frameBuffer), 0);
+#else
+    executor.EnableNonBlocking(frameBuffer, sizeof(frameBuffer), '\n');
+#endif
 }
 
 void loop()
 {
-    executor.Tick(Timeout::Milliseconds(1000));
+    executor.Tick(Timeout::Milliseconds(0));
 }
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// @brief A bump allocator over caller-provided storage, for the variable-length arguments of a request.
+/// Strings and arrays read through `ObjectStream::ReadString` and `ObjectStream::ReadArray` are
+/// placed in it instead of on the heap or in fixed per-command buffers. Allocations are never freed
+/// one by one: the executor resets the whole arena at the end of every `Tick`, see
+/// `CommandExecutorCore::EnableArena`, so data in it only lives for the frame that read it.
+/// `HighWaterMark` shows how much of the storage the busiest frame needed, for sizing it.
+class Arena {
+    uint8_t* storage;        ///< The storage allocations are carved from.
+    size_t capacity;         ///< Size of `storage` in bytes.
+    size_t used = 0;         ///< Bytes allocated since the last `Reset`, including alignment padding.
+    size_t highWater = 0;    ///< The largest `used` seen.
+    uint32_t exhausted = 0;  ///< Allocations that did not fit.
+
+public:
+    /// @brief Constructs an empty arena over existing storage.
+    /// @param buf The storage; allocations keep the alignment they ask for relative to its address.
+    /// @param size The size of `buf` in bytes.
+    Arena(uint8_t* buf, size_t size) : storage(buf), capacity(size) {}
+
+    /// @brief Allocates uninitialized memory.
+    /// @param size The number of bytes.
+    /// @param align The alignment, a power of two.
+    /// @return The memory, or nullptr if it does not fit in what is left.
+    void* Allocate(size_t size, size_t align) {
+        size_t start = Align(align);
+        if (start > capacity || size > capacity - start) {
+            Overflow();
+            return nullptr;
+        }
+        Claim(start + size);
+        return storage + start;
+    }
+
+    /// @brief Allocates uninitialized storage for `count` elements of `T`.
+    /// @return The storage, or nullptr if it does not fit in what is left.
+    template <typename T>
+    T* Allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) {
+            Overflow();
+            return nullptr;
+        }
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// @brief Returns the unallocated rest of the arena, aligned for `T`, without allocating it.
+    /// Used to read data whose size is only known once it has been read: the reader fills the
+    /// free space, then keeps what it used with `Commit`.
+    /// @param count Set to the number of elements of `T` that fit.
+    /// @return The start of the free space.
+    template <typename T>
+    T* Free(size_t& count) const {
+        size_t start = Align(alignof(T));
+        count = start < capacity ? (capacity - start) / sizeof(T) : 0;
+        return reinterpret_cast<T*>(storage + (start < capacity ? start : capacity));
+    }
+
+    /// @brief Allocates the first `count` elements of the free space returned by `Free`.
+    template <typename T>
+    void Commit(const T* data, size_t count) {
+        Claim(reinterpret_cast<const uint8_t*>(data + count) - storage);
+    }
+
+    /// @brief Records an allocation that did not fit in what is left.
+    /// `Allocate` calls it itself; a reader filling the space returned by `Free` calls it when the
+    /// data turns out larger. Since the frame needed at least the whole storage, the high-water
+    /// mark is raised to `Capacity`.
+    void Overflow() {
+        exhausted++;
+        highWater = capacity;
+    }
+
+    /// @brief Frees every allocation; the memory handed out before must no longer be used.
+    void Reset() {
+        used = 0;
+    }
+
+    /// @brief Returns the bytes allocated since the last `Reset`.
+    size_t Used() const { return used; }
+
+    /// @brief Returns the size of the storage in bytes.
+    size_t Capacity() const { return capacity; }
+
+    /// @brief Returns the most bytes that were allocated at once since construction or `ResetStatistics`,
+    /// `Capacity` if an allocation did not fit.
+    size_t HighWaterMark() const { return highWater; }
+
+    /// @brief Returns the number of allocations that did not fit, see `Overflow`, including arena
+    /// reads whose data was larger than what was left.
+    uint32_t Exhausted() const { return exhausted; }
+
+    /// @brief Clears the high-water mark and the exhausted count.
+    void ResetStatistics() {
+        highWater = used;
+        exhausted = 0;
+    }
+
+private:
+    /// @brief Returns the offset of the first free byte aligned to `align`.
+    size_t Align(size_t align) const {
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage + used);
+        return used + ((0 - address) & (align - 1));
+    }
+
+    void Claim(size_t end) {
+        used = end;
+        if (used > highWater) {
+            highWater = used;
+        }
+    }
+};
+
+/// @brief An `Arena` with its storage inline, typically a global next to the executor.
+/// @tparam N The size of the arena in bytes.
+template <size_t N>
+class StaticArena : public Arena {
+    static_assert(N > 0, "An arena needs storage");
+
+    alignas(alignof(std::max_align_t)) uint8_t bytes[N];
+
+public:
+    /// @brief Constructs an empty arena.
+    StaticArena() : Arena(bytes, N) {}
+};
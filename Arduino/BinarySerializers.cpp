@@ -0,0 +1,485 @@
+#include "BinarySerializers.h"
+#include "IStream.h"
+#include "ByteSpan.h"
+#include "CommandStructures.h"
+#include <climits>
+#include <cstring>
+
+// Compact binary wire format:
+//  - integers are LEB128 varints, signed values are zigzag encoded first
+//  - floats are 4 byte IEEE-754, little endian
+//  - result codes are a single byte
+//  - requests are the request id followed by the command code
+//  - blobs and strings are a varint length followed by the raw bytes, strings without a terminator
+//  - arrays are a varint element count followed by the elements as fixed size little endian values
+
+// Write all bytes or fail
+static bool WriteAll(IStream &stream, const void *data, size_t size, const Timeout &timeout)
+{
+    return stream.Write(data, size, timeout) == size;
+}
+
+// Read exactly `size` bytes, streams are allowed to return partial reads
+static bool ReadAll(IStream &stream, void *data, size_t size, const Timeout &timeout)
+{
+    uint8_t *bytes = static_cast<uint8_t *>(data);
+    size_t received = 0;
+    while (received < size)
+    {
+        size_t bytesRead = stream.Read(bytes + received, size - received, timeout);
+        if (bytesRead == 0 && timeout.Expired())
+        {
+            return false;
+        }
+        received += bytesRead;
+    }
+    return true;
+}
+
+static bool WriteVarint(IStream &stream, uint64_t value, const Timeout &timeout)
+{
+    uint8_t buffer[10];
+    size_t len = 0;
+    while (value >= 0x80)
+    {
+        buffer[len++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    buffer[len++] = static_cast<uint8_t>(value);
+    return WriteAll(stream, buffer, len, timeout);
+}
+
+// Adds the payload of one varint byte to value, returns false if it does not fit in 64 bits
+static bool AppendVarintByte(uint64_t &value, unsigned &shift, uint8_t byte)
+{
+    if (shift >= 64)
+    {
+        return false; // Too many continuation bytes
+    }
+
+    uint64_t bits = static_cast<uint64_t>(byte & 0x7F);
+    if (shift == 63 && bits > 1)
+    {
+        return false; // More than 64 bits of payload
+    }
+    value |= bits << shift;
+    shift += 7;
+    return true;
+}
+
+// Reads a varint and rejects values that do not fit in `maxValue`.
+// Buffered streams are decoded in place, other streams one byte at a time.
+static bool ReadVarint(IStream &stream, uint64_t &value, uint64_t maxValue, const Timeout &timeout)
+{
+    value = 0;
+    unsigned shift = 0;
+    while (true)
+    {
+        const uint8_t *window;
+        size_t available = stream.Peek(window, timeout);
+        if (available > 0)
+        {
+            for (size_t i = 0; i < available; ++i)
+            {
+                if (!AppendVarintByte(value, shift, window[i]))
+                {
+                    stream.Consume(i + 1);
+                    return false;
+                }
+                if ((window[i] & 0x80) == 0)
+                {
+                    stream.Consume(i + 1);
+                    return value <= maxValue;
+                }
+            }
+            stream.Consume(available);
+            continue;
+        }
+
+        uint8_t byte;
+        if (!ReadAll(stream, &byte, 1, timeout) || !AppendVarintByte(value, shift, byte))
+        {
+            return false;
+        }
+        if ((byte & 0x80) == 0)
+        {
+            return value <= maxValue;
+        }
+    }
+}
+
+static uint64_t ZigZagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t ZigZagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const int &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, ZigZagEncode(item), timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, int &item, const Timeout &timeout)
+{
+    uint64_t raw;
+    if (!ReadVarint(stream, raw, UINT32_MAX, timeout))
+    {
+        return false;
+    }
+    item = static_cast<int>(ZigZagDecode(raw));
+    return true;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const unsigned int &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, unsigned int &item, const Timeout &timeout)
+{
+    uint64_t raw;
+    if (!ReadVarint(stream, raw, UINT_MAX, timeout))
+    {
+        return false;
+    }
+    item = static_cast<unsigned int>(raw);
+    return true;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const int64_t &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, ZigZagEncode(item), timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, int64_t &item, const Timeout &timeout)
+{
+    uint64_t raw;
+    if (!ReadVarint(stream, raw, UINT64_MAX, timeout))
+    {
+        return false;
+    }
+    item = ZigZagDecode(raw);
+    return true;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const uint64_t &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, uint64_t &item, const Timeout &timeout)
+{
+    return ReadVarint(stream, item, UINT64_MAX, timeout);
+}
+
+// Hex only changes the text representation, on the wire it is a plain varint
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const Hex &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, item.value, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, Hex &item, const Timeout &timeout)
+{
+    return ReadVarint(stream, item.value, UINT64_MAX, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const float &item, const Timeout &timeout)
+{
+    uint32_t bits;
+    memcpy(&bits, &item, sizeof(bits));
+    uint8_t buffer[4] = {
+        static_cast<uint8_t>(bits),
+        static_cast<uint8_t>(bits >> 8),
+        static_cast<uint8_t>(bits >> 16),
+        static_cast<uint8_t>(bits >> 24),
+    };
+    return WriteAll(stream, buffer, sizeof(buffer), timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, float &item, const Timeout &timeout)
+{
+    uint8_t buffer[4];
+    if (!ReadAll(stream, buffer, sizeof(buffer), timeout))
+    {
+        return false;
+    }
+    uint32_t bits = static_cast<uint32_t>(buffer[0]) |
+                    static_cast<uint32_t>(buffer[1]) << 8 |
+                    static_cast<uint32_t>(buffer[2]) << 16 |
+                    static_cast<uint32_t>(buffer[3]) << 24;
+    memcpy(&item, &bits, sizeof(item));
+    return true;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+// Reverses the bytes of each element, converting between host and wire order
+template <typename T>
+static void SwapElements(uint8_t *bytes, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, bytes += sizeof(T))
+    {
+        for (size_t j = 0; j < sizeof(T) / 2; ++j)
+        {
+            uint8_t byte = bytes[j];
+            bytes[j] = bytes[sizeof(T) - 1 - j];
+            bytes[sizeof(T) - 1 - j] = byte;
+        }
+    }
+}
+#endif
+
+// On little endian targets the wire order is the memory order: the elements are written
+// straight from the caller's array, in a single stream write
+template <typename T>
+static bool WriteSpan(IStream &stream, const ConstSpan<T> &item, const Timeout &timeout)
+{
+    if (!WriteVarint(stream, item.size, timeout))
+    {
+        return false;
+    }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint8_t chunk[32];
+    constexpr size_t perChunk = sizeof(chunk) / sizeof(T);
+    for (size_t i = 0; i < item.size; i += perChunk)
+    {
+        size_t count = item.size - i < perChunk ? item.size - i : perChunk;
+        memcpy(chunk, item.data + i, count * sizeof(T));
+        SwapElements<T>(chunk, count);
+        if (!WriteAll(stream, chunk, count * sizeof(T), timeout))
+        {
+            return false;
+        }
+    }
+    return true;
+#else
+    return WriteAll(stream, item.data, item.size * sizeof(T), timeout);
+#endif
+}
+
+// The elements are read straight into the caller's buffer
+template <typename T>
+static bool ReadSpan(IStream &stream, SpanBuffer<T> &item, const Timeout &timeout)
+{
+    uint64_t size;
+    if (!ReadVarint(stream, size, SIZE_MAX, timeout))
+    {
+        return false;
+    }
+    if (size > item.capacity)
+    {
+        item.size = static_cast<size_t>(size);
+        return false; // Array does not fit the caller's buffer
+    }
+    item.size = static_cast<size_t>(size);
+    if (!ReadAll(stream, item.data, item.size * sizeof(T), timeout))
+    {
+        return false;
+    }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    SwapElements<T>(reinterpret_cast<uint8_t *>(item.data), item.size);
+#endif
+    return true;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstByteSpan &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, blobs are deserialized into a ByteBuffer
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstByteSpan &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ByteBuffer &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstByteSpan{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ByteBuffer &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int16_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<int16_t>{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int16_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint16_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint16_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<uint16_t>{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint16_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int32_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<int32_t>{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int32_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint32_t> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint32_t> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<uint32_t>{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint32_t> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<float> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<float> &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<float> &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstSpan<float>{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<float> &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstText &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, item, timeout);
+}
+
+// A read-only view cannot receive data, strings are deserialized into a TextBuffer
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstText &item, const Timeout &timeout)
+{
+    return false;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const TextBuffer &item, const Timeout &timeout)
+{
+    return WriteSpan(stream, ConstText{item.data, item.size}, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, TextBuffer &item, const Timeout &timeout)
+{
+    return ReadSpan(stream, item, timeout);
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const CommandRequest &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, item.id, timeout) && WriteVarint(stream, item.cmd, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, CommandRequest &item, const Timeout &timeout)
+{
+    uint64_t id, cmd;
+    if (!ReadVarint(stream, id, UINT32_MAX, timeout) || !ReadVarint(stream, cmd, UINT32_MAX, timeout))
+    {
+        return false;
+    }
+    item.id = static_cast<uint32_t>(id);
+    item.cmd = static_cast<uint32_t>(cmd);
+    return true;
+}
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ResponseHeader &item, const Timeout &timeout)
+{
+    return WriteVarint(stream, item.id, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ResponseHeader &item, const Timeout &timeout)
+{
+    uint64_t id;
+    if (!ReadVarint(stream, id, UINT32_MAX, timeout))
+    {
+        return false;
+    }
+    item.id = static_cast<uint32_t>(id);
+    return true;
+}
+
+// The request id travels in the ResponseHeader, the result itself is one byte
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const CommandResult &item, const Timeout &timeout)
+{
+    uint8_t code = static_cast<uint8_t>(item.resultCode);
+    return WriteAll(stream, &code, 1, timeout);
+}
+
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, CommandResult &item, const Timeout &timeout)
+{
+    uint8_t code;
+    if (!ReadAll(stream, &code, 1, timeout))
+    {
+        return false;
+    }
+    item.resultCode = static_cast<CommandResultCodes>(code);
+    return true;
+}
+
+// Static method to create the binary serializer
+Serializer SerializerFactory::CreateBinarySerializer()
+{
+    return Serializer(BinarySerializerTable);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Serializer.h"
+
+// Compact binary format, see BinarySerializers.cpp for the encoding
+
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const int &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, int &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const unsigned int &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, unsigned int &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const int64_t &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, int64_t &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const uint64_t &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, uint64_t &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const float &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, float &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const Hex &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, Hex &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstByteSpan &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstByteSpan &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ByteBuffer &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ByteBuffer &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int16_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int16_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int16_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int16_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint16_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint16_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint16_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint16_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<int32_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<int32_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<int32_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<int32_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<uint32_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<uint32_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<uint32_t> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<uint32_t> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstSpan<float> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstSpan<float> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const SpanBuffer<float> &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, SpanBuffer<float> &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ConstText &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ConstText &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const TextBuffer &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, TextBuffer &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const CommandRequest &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, CommandRequest &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const ResponseHeader &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, ResponseHeader &item, const Timeout &timeout);
+bool Binary_Serialize(const Serializer &serializer, IStream &stream, const CommandResult &item, const Timeout &timeout);
+bool Binary_Deserialize(const Serializer &serializer, IStream &stream, CommandResult &item, const Timeout &timeout);
+
+// Define the binary format table
+constexpr SerializerEntry binarySerializerEntries[] = {
+    SERIALIZER_ENTRY(int, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(unsigned int, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(int64_t, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(uint64_t, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(float, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(Hex, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstByteSpan, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ByteBuffer, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<int16_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<int16_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<uint16_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<uint16_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<int32_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<int32_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<uint32_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<uint32_t>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstSpan<float>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(SpanBuffer<float>, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ConstText, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(TextBuffer, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(CommandRequest, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(CommandResult, Binary_Serialize, Binary_Deserialize),
+    SERIALIZER_ENTRY(ResponseHeader, Binary_Serialize, Binary_Deserialize),
+};
+
+inline constexpr SerializerTable BinarySerializerTable = MakeSerializerTable(binarySerializerEntries);
+
+// Serializer with the binary format resolved at compile time
+using BinarySerializer = StaticSerializer<BinarySerializerTable>;
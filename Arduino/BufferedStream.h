@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "IStream.h"
+
+/// @brief An `IStream` decorator that buffers reads and writes to the underlying stream.
+/// Instead of one call into the base stream per byte, `BufferedStream` refills an internal
+/// buffer with whatever the base stream has available and serves reads from it. Parsers can
+/// use `Peek` and `Consume` to scan a whole buffered chunk for a delimiter in one pass.
+/// Writes are collected in a second buffer and passed on as a single write on `Flush`, so a
+/// response assembled from many small writes leaves as one burst. Data written without a
+/// `Flush` stays in the buffer.
+/// @tparam RxSize The size of the read buffer in bytes.
+/// @tparam TxSize The size of the write buffer in bytes.
+template <size_t RxSize, size_t TxSize = RxSize>
+class BufferedStream : public IStream {
+    IStream& baseStream;      ///< Reference to the underlying stream.
+    uint8_t buffer[RxSize];   ///< Read buffer, holds the bytes in [head, tail).
+    size_t head = 0;          ///< Offset of the first unread byte.
+    size_t tail = 0;          ///< Offset past the last buffered byte.
+    uint8_t txBuffer[TxSize]; ///< Write buffer, holds `txLength` bytes waiting for `Flush`.
+    size_t txLength = 0;      ///< Number of bytes in the write buffer.
+
+public:
+    /// @brief Constructs a `BufferedStream` over an existing stream.
+    /// @param stream The stream to read from and write to.
+    BufferedStream(IStream& stream) : baseStream(stream) {}
+
+    /// @brief Returns the number of bytes buffered but not yet read.
+    size_t Buffered() const { return tail - head; }
+
+    /// @brief Reads buffered bytes, refilling the buffer from the base stream when it is empty.
+    /// @param data A pointer to the buffer where the read data will be stored.
+    /// @param size The maximum number of bytes to read.
+    /// @param timeout A `Timeout` object specifying the maximum time to wait for data.
+    /// @return The number of bytes read; may be less than `size` if no more data was available.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* window;
+        size_t available = Peek(window, timeout);
+        size_t count = size < available ? size : available;
+        memcpy(data, window, count);
+        head += count;
+        return count;
+    }
+
+    /// @brief Appends data to the write buffer.
+    /// If the data does not fit, the buffer is written to the base stream first. Data larger
+    /// than the whole buffer is written directly.
+    /// @param data A pointer to the buffer containing the data to write.
+    /// @param size The number of bytes to write.
+    /// @param timeout A `Timeout` object used if the buffer has to be written out.
+    /// @return The number of bytes accepted. Returns 0 if buffered data could not be written in time.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        if (size > TxSize - txLength) {
+            WriteBuffer(timeout);
+            if (txLength) {
+                return 0; // Base stream did not take the buffered data in time
+            }
+            if (size >= TxSize) {
+                return baseStream.Write(data, size, timeout);
+            }
+        }
+        memcpy(txBuffer + txLength, data, size);
+        txLength += size;
+        return size;
+    }
+
+    /// @brief Writes the buffered data to the base stream in one call and flushes it.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for flushing.
+    virtual void Flush(const Timeout& timeout) override {
+        WriteBuffer(timeout);
+        baseStream.Flush(timeout);
+    }
+
+    /// @brief Returns the buffered bytes without consuming them, refilling the buffer if it is empty.
+    /// @param data Set to the first unread byte.
+    /// @param timeout A `Timeout` object specifying the maximum time to wait for data.
+    /// @return The number of contiguous bytes available at `data`, 0 if the timeout expired.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        if (head == tail) {
+            head = 0;
+            tail = baseStream.Read(buffer, RxSize, timeout);
+        }
+        data = buffer + head;
+        return tail - head;
+    }
+
+    /// @brief Consumes bytes previously returned by `Peek`.
+    /// @param size The number of bytes to consume, at most the amount returned by `Peek`.
+    virtual void Consume(size_t size) override {
+        head += size;
+    }
+
+private:
+    /// @brief Passes the write buffer to the base stream, keeping any bytes it did not accept.
+    void WriteBuffer(const Timeout& timeout) {
+        if (!txLength) {
+            return;
+        }
+        size_t written = baseStream.Write(txBuffer, txLength, timeout);
+        memmove(txBuffer, txBuffer + written, txLength - written);
+        txLength -= written;
+    }
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// @brief A read-only view of an array of elements.
+/// Used to serialize arrays straight from the caller's memory, in one pass.
+/// Element types with a serializer slot: uint8_t, int16_t, uint16_t, int32_t, uint32_t, float and char.
+/// @tparam T The element type.
+template <typename T>
+struct ConstSpan {
+    const T* data; ///< Pointer to the first element.
+    size_t size;   ///< Number of elements in the view.
+};
+
+/// @brief A caller-owned array that receives a deserialized array.
+/// Deserialization fails if the incoming array has more than `capacity` elements, and then sets
+/// `size` beyond `capacity`: to the incoming size where the format announces it, else to `capacity` + 1.
+/// @tparam T The element type.
+template <typename T>
+struct SpanBuffer {
+    T* data;         ///< Pointer to the storage provided by the caller.
+    size_t capacity; ///< Number of elements available at `data`.
+    size_t size;     ///< Number of elements received, set by deserialization.
+};
+
+/// @brief A read-only view of a block of bytes.
+/// Used to serialize blobs straight from the caller's memory.
+using ConstByteSpan = ConstSpan<uint8_t>;
+
+/// @brief A caller-owned buffer that receives a deserialized blob.
+/// Deserialization fails if the incoming blob is larger than `capacity`.
+using ByteBuffer = SpanBuffer<uint8_t>;
+
+/// @brief A read-only view of a string, not necessarily null-terminated.
+/// Text formats write it quoted, binary formats like a blob.
+using ConstText = ConstSpan<char>;
+
+/// @brief A caller-owned buffer that receives a deserialized string, without a terminator.
+/// Deserialization fails if the incoming string is longer than `capacity`.
+using TextBuffer = SpanBuffer<char>;
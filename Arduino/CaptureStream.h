@@ -0,0 +1,241 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "IStream.h"
+
+/// @file CaptureStream.h
+/// @brief Recording of the timed traffic of a stream, for replaying it off-device.
+///
+/// A capture is the 4 byte `CaptureMagic` followed by one record per read or write:
+///  - a varint holding the number of bytes shifted left by one, the low bit set for sent bytes
+///  - a varint holding the microseconds since the previous record
+///  - the bytes
+///
+/// Varints are LEB128, as in the binary wire format, so a 1 byte request read 300 us after the
+/// previous one costs 4 bytes of capture. The first record's time is not meaningful, replays
+/// start with it. `CaptureStream` records the traffic of the stream it wraps into an `ICaptureSink`:
+/// a `CaptureRing` keeps the latest traffic in RAM on the target, the host's `CaptureFile` writes
+/// it to a file. The `capture_replay` tool feeds a capture through a host build of the executor.
+
+/// @brief The bytes every capture starts with.
+constexpr uint8_t CaptureMagic[4] = {'C', 'K', 'C', '1'};
+
+/// @brief The longest encoded record header.
+constexpr size_t CaptureHeaderMax = 10;
+
+/// @brief The direction of recorded bytes, seen from the device.
+enum class CaptureDirection : uint8_t {
+    Received = 0, ///< Bytes read from the stream.
+    Sent = 1,     ///< Bytes written to the stream.
+};
+
+/// @brief Appends a varint to `out` and returns the new length.
+inline size_t PutCaptureVarint(uint8_t* out, size_t length, uint32_t value) {
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+/// @brief Encodes a record header into `out`, which needs `CaptureHeaderMax` bytes.
+/// @return The length of the header.
+inline size_t EncodeCaptureHeader(uint8_t* out, CaptureDirection direction, uint32_t deltaUs, size_t size) {
+    size_t length = PutCaptureVarint(out, 0, static_cast<uint32_t>(size) << 1 | static_cast<uint32_t>(direction));
+    return PutCaptureVarint(out, length, deltaUs);
+}
+
+/// @brief Decodes a record header.
+/// @param data The header bytes.
+/// @param available The number of bytes at `data`.
+/// @param direction Set to the direction of the record.
+/// @param deltaUs Set to the microseconds since the previous record.
+/// @param size Set to the number of recorded bytes following the header.
+/// @return The length of the header, or 0 if it is truncated or malformed.
+inline size_t DecodeCaptureHeader(const uint8_t* data, size_t available, CaptureDirection& direction,
+                                  uint32_t& deltaUs, size_t& size) {
+    uint32_t values[2];
+    size_t length = 0;
+    for (uint32_t& value : values) {
+        value = 0;
+        for (uint8_t shift = 0;; shift += 7) {
+            if (length == available || shift > 28) {
+                return 0;
+            }
+            uint8_t byte = data[length++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+    }
+    direction = static_cast<CaptureDirection>(values[0] & 1);
+    size = values[0] >> 1;
+    deltaUs = values[1];
+    return length;
+}
+
+/// @brief Receives the records of a `CaptureStream`.
+class ICaptureSink {
+public:
+    /// @brief Records bytes that were read or written.
+    /// @param direction Whether the bytes were read or written.
+    /// @param timeUs The `TimeoutClock` reading when they were.
+    /// @param data The bytes.
+    /// @param size The number of bytes, at least 1.
+    virtual void Record(CaptureDirection direction, uint32_t timeUs, const uint8_t* data, size_t size) = 0;
+};
+
+/// @brief A capture of the latest traffic in caller-provided RAM.
+/// When a record does not fit, the oldest records are dropped to make room, so the ring always
+/// holds the traffic leading up to now, for example up to the moment a unit misbehaved. A record
+/// larger than the whole ring is dropped. `Dump` writes the capture out, oldest record first.
+class CaptureRing : public ICaptureSink {
+    uint8_t* ring;           ///< The records, wrapping around.
+    size_t capacity;         ///< Size of `ring` in bytes.
+    size_t start = 0;        ///< Offset of the oldest record.
+    size_t length = 0;       ///< Bytes of records held.
+    uint32_t lastUs = 0;     ///< Time of the newest record.
+    uint32_t dropped = 0;    ///< Records dropped for lack of room.
+
+public:
+    /// @brief Constructs an empty ring over existing storage.
+    /// @param buf The storage for the records.
+    /// @param size The size of `buf` in bytes.
+    CaptureRing(uint8_t* buf, size_t size) : ring(buf), capacity(size) {}
+
+    virtual void Record(CaptureDirection direction, uint32_t timeUs, const uint8_t* data, size_t size) override {
+        uint8_t header[CaptureHeaderMax];
+        size_t headerSize = EncodeCaptureHeader(header, direction, length ? timeUs - lastUs : 0, size);
+        if (size > capacity || headerSize > capacity - size) {
+            dropped++;
+            return;
+        }
+        while (capacity - length < headerSize + size) {
+            DropOldest();
+        }
+        Put(header, headerSize);
+        Put(data, size);
+        lastUs = timeUs;
+    }
+
+    /// @brief Writes the capture, `CaptureMagic` and then the records held, oldest first.
+    /// @param stream The stream receiving the capture, for example the serial port or a log file.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the writes.
+    /// @return True if the whole capture was written.
+    bool Dump(IStream& stream, const Timeout& timeout) const {
+        size_t first = length < capacity - start ? length : capacity - start;
+        return stream.Write(CaptureMagic, sizeof(CaptureMagic), timeout) == sizeof(CaptureMagic) &&
+               stream.Write(ring + start, first, timeout) == first &&
+               stream.Write(ring, length - first, timeout) == length - first;
+    }
+
+    /// @brief Drops all records.
+    void Clear() {
+        start = 0;
+        length = 0;
+    }
+
+    /// @brief Returns the bytes of records held.
+    size_t Length() const { return length; }
+
+    /// @brief Returns the number of records dropped to make room, or because they did not fit at all.
+    uint32_t Dropped() const { return dropped; }
+
+private:
+    /// @brief Appends bytes behind the newest record, which the caller made room for.
+    void Put(const uint8_t* data, size_t size) {
+        size_t end = (start + length) % capacity;
+        size_t first = size < capacity - end ? size : capacity - end;
+        memcpy(ring + end, data, first);
+        memcpy(ring, data + first, size - first);
+        length += size;
+    }
+
+    /// @brief Removes the oldest record.
+    void DropOldest() {
+        uint8_t header[CaptureHeaderMax];
+        size_t available = length < sizeof(header) ? length : sizeof(header);
+        for (size_t i = 0; i < available; ++i) {
+            header[i] = ring[(start + i) % capacity];
+        }
+        CaptureDirection direction;
+        uint32_t deltaUs;
+        size_t size = 0;
+        size_t headerSize = DecodeCaptureHeader(header, available, direction, deltaUs, size);
+        size_t total = headerSize + size;
+        if (headerSize == 0 || total > length) {
+            total = length; // Only possible if the storage was overwritten; start over
+        }
+        start = (start + total) % capacity;
+        length -= total;
+        dropped++;
+    }
+};
+
+/// @brief A `CaptureRing` with its storage inline.
+/// @tparam N The size of the ring in bytes.
+template <size_t N>
+class StaticCaptureRing : public CaptureRing {
+    static_assert(N > 0, "A capture ring needs storage");
+
+    uint8_t bytes[N];
+
+public:
+    /// @brief Constructs an empty ring.
+    StaticCaptureRing() : CaptureRing(bytes, N) {}
+};
+
+/// @brief An `IStream` decorator that records the bytes read from and written to another stream.
+/// Every read, consumed `Peek` window and write becomes a record timestamped with `TimeoutClock`,
+/// so the capture keeps the chunking and timing the executor saw. Recording costs a clock read and
+/// a virtual call per operation plus the sink's copy, so wrap the unbuffered stream below a
+/// `BufferedStream` to record a few large reads rather than many small ones.
+class CaptureStream : public IStream {
+    IStream& baseStream;             ///< The stream being recorded.
+    ICaptureSink& sink;              ///< Receives the records.
+    const uint8_t* peeked = nullptr; ///< The window returned by the last `Peek`.
+
+public:
+    /// @brief Constructs a recording stream.
+    /// @param stream The stream being recorded.
+    /// @param captureSink Receives the records.
+    CaptureStream(IStream& stream, ICaptureSink& captureSink) : baseStream(stream), sink(captureSink) {}
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        size_t count = baseStream.Read(data, size, timeout);
+        if (count) {
+            sink.Record(CaptureDirection::Received, TimeoutClock::Now(), static_cast<const uint8_t*>(data), count);
+        }
+        return count;
+    }
+
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        size_t available = baseStream.Peek(data, timeout);
+        peeked = available ? data : nullptr;
+        return available;
+    }
+
+    /// @brief Consumes bytes of the last `Peek` window and records them as received.
+    virtual void Consume(size_t size) override {
+        if (size && peeked) {
+            sink.Record(CaptureDirection::Received, TimeoutClock::Now(), peeked, size);
+            peeked += size;
+        }
+        baseStream.Consume(size);
+    }
+
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        size_t written = baseStream.Write(data, size, timeout);
+        if (written) {
+            sink.Record(CaptureDirection::Sent, TimeoutClock::Now(), static_cast<const uint8_t*>(data), written);
+        }
+        return written;
+    }
+
+    virtual void Flush(const Timeout& timeout) override {
+        baseStream.Flush(timeout);
+    }
+};
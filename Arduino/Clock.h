@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+#include <cstdint>
+
+/// @file Clock.h
+/// @brief Clock policies for `Timeout` and the executor statistics.
+/// A clock policy is a type with a `static uint32_t Now()` returning microseconds from a free-running
+/// counter; it may wrap, all arithmetic on it is modular. `TimeoutClock` selects the one in use:
+/// define `COMMANDKIT_CLOCK` as the policy type (declared before this header is included, or one of
+/// the policies below) on the compiler command line to replace the default `MicrosClock`.
+
+/// @brief The Arduino `micros()` counter, a hardware timer on the target. In host builds the
+/// Arduino shim backs it with `std::chrono::steady_clock`.
+struct MicrosClock {
+    static uint32_t Now() {
+        return static_cast<uint32_t>(micros());
+    }
+};
+
+/// @brief A clock that only moves when told to, for deterministic host runs of timing-dependent code.
+/// Build with `COMMANDKIT_CLOCK=FakeClock`; a wait on a `Timeout` then only ends once another
+/// thread or a stream under test calls `Advance`.
+struct FakeClock {
+    static uint32_t Now() {
+        return Time();
+    }
+
+    /// @brief Moves the clock forward.
+    static void Advance(uint32_t micros) {
+        Time() += micros;
+    }
+
+    /// @brief Sets the clock, for example just below the wrap to test overflow handling.
+    static void Set(uint32_t micros) {
+        Time() = micros;
+    }
+
+private:
+    static uint32_t& Time() {
+        static uint32_t now = 0;
+        return now;
+    }
+};
+
+#ifndef COMMANDKIT_CLOCK
+#define COMMANDKIT_CLOCK MicrosClock
+#endif
+
+/// @brief The clock policy used by `Timeout`, see `COMMANDKIT_CLOCK`.
+using TimeoutClock = COMMANDKIT_CLOCK;
@@ -0,0 +1,227 @@
+#pragma once
+#include <cstring>
+#include "Framing.h"
+#include "Crc.h"
+
+/// @brief A binary safe `Framing` implementation using COBS encoding with a CRC-16 per frame.
+/// Each frame is the COBS encoding of the payload followed by its CRC-16/CCITT-FALSE (big-endian),
+/// terminated by a zero byte. COBS guarantees the zero byte never occurs inside a frame, so the
+/// receiver always resynchronizes at the next frame boundary, whatever bytes were lost or corrupted.
+///
+/// Incoming frames are decoded into a caller-provided buffer while they arrive, and the CRC is
+/// updated byte by byte, so a corrupted or oversized frame is rejected in constant time once its
+/// terminator is seen. Reads are then served from the buffer; `Peek` exposes it directly, so
+/// deserializers parse the payload in place without copying it.
+/// Outgoing data is collected in a second caller-provided buffer and encoded on `Flush`.
+class CobsFraming : public Framing {
+    uint8_t* rxBuffer;        ///< Receives the decoded payload of the current frame.
+    size_t rxCapacity;        ///< Size of `rxBuffer`.
+    size_t rxLength = 0;      ///< Payload length of the current frame.
+    size_t rxPos = 0;         ///< Read position within the current frame.
+    bool frameReady = false;  ///< Set once a complete, valid frame has been received.
+
+    uint8_t* txBuffer;        ///< Collects the payload of the outgoing frame.
+    size_t txCapacity;        ///< Size of `txBuffer`.
+    size_t txLength = 0;      ///< Number of payload bytes written so far.
+    bool txOverflow = false;  ///< The outgoing frame did not fit `txBuffer`; it is dropped on `Flush`.
+
+    size_t decodedLength = 0;     ///< Decoded bytes of the frame being received, including the CRC.
+    uint16_t decodedCrc = Crc16Initial; ///< Running CRC over the decoded bytes.
+    uint8_t blockRemaining = 0;   ///< Data bytes left in the current COBS block.
+    bool pendingZero = false;     ///< The current block stands for a trailing zero, unless the frame ends.
+    bool overflow = false;        ///< The frame being received does not fit `rxBuffer`.
+
+    static constexpr size_t CrcSize = 2;
+
+public:
+    /// @brief Constructs a `CobsFraming` object over an existing stream.
+    /// @param stream The base stream to which framing operations will be applied.
+    /// @param rxBuf Buffer receiving incoming frames; needs room for the largest payload plus 2 CRC bytes.
+    /// @param rxSize Size of `rxBuf` in bytes.
+    /// @param txBuf Buffer collecting the outgoing frame; needs room for the largest payload plus 2 CRC bytes.
+    /// @param txSize Size of `txBuf` in bytes; below 2 nothing can be sent, as for a framing only used to receive.
+    CobsFraming(IStream& stream, uint8_t* rxBuf, size_t rxSize, uint8_t* txBuf, size_t txSize)
+        : Framing(stream), rxBuffer(rxBuf), rxCapacity(rxSize), txBuffer(txBuf), txCapacity(txSize) {}
+
+    /// @brief Reads payload bytes of the current frame, receiving the frame first if needed.
+    /// Corrupted frames are dropped and the next frame is awaited within the same timeout.
+    /// @param data A pointer to the buffer where the read data will be stored.
+    /// @param size The maximum number of bytes to read.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for receiving the frame.
+    /// @return The number of bytes read. Returns 0 at the end of the frame or if no frame arrived in time.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* window;
+        size_t available = Peek(window, timeout);
+        size_t count = size < available ? size : available;
+        memcpy(data, window, count);
+        rxPos += count;
+        return count;
+    }
+
+    /// @brief Exposes the unread payload of the current frame in the receive buffer.
+    /// @param data Set to the first unread payload byte.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for receiving the frame.
+    /// @return The number of unread payload bytes, 0 at the end of the frame or if no frame arrived in time.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        if (!frameReady) {
+            frameReady = ReceiveFrame(timeout);
+        }
+        data = rxBuffer + rxPos;
+        return rxLength - rxPos;
+    }
+
+    /// @brief Consumes payload bytes previously exposed by `Peek`.
+    virtual void Consume(size_t size) override {
+        rxPos += size;
+    }
+
+    /// @brief Returns true once a frame has been received and all of its payload has been read.
+    virtual bool EndOfFrame() const override {
+        return frameReady && rxPos >= rxLength;
+    }
+
+    /// @brief Returns the number of payload bytes of the current frame read so far.
+    virtual size_t FramePosition() const override {
+        return rxPos;
+    }
+
+    /// @brief Appends data to the outgoing frame.
+    /// A frame that does not fit the transmit buffer is dropped on `Flush` rather than sent truncated,
+    /// as a truncated frame would still carry a valid CRC; the peer's request times out instead.
+    /// @param data A pointer to the buffer containing the data to write.
+    /// @param size The number of bytes to write.
+    /// @param timeout Unused, data is only sent on `Flush`.
+    /// @return The number of bytes accepted; fewer than `size` if the transmit buffer is full.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        size_t payloadCapacity = txCapacity > CrcSize ? txCapacity - CrcSize : 0;
+        size_t space = payloadCapacity - txLength;
+        size_t count = size < space ? size : space;
+        if (count < size) {
+            txOverflow = true;
+        }
+        if (count) {
+            memcpy(txBuffer + txLength, data, count);
+            txLength += count;
+        }
+        return count;
+    }
+
+    /// @brief Encodes and sends the outgoing frame, if anything was written, and flushes the base stream.
+    /// A frame that overflowed the transmit buffer is discarded instead, see `Write`.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for sending.
+    virtual void Flush(const Timeout& timeout) override {
+        if (txOverflow) {
+            txLength = 0;
+            txOverflow = false;
+        }
+        if (txLength) {
+            uint16_t crc = Crc16(txBuffer, txLength);
+            txBuffer[txLength++] = static_cast<uint8_t>(crc >> 8);
+            txBuffer[txLength++] = static_cast<uint8_t>(crc);
+            Encode(txBuffer, txLength, timeout);
+            txLength = 0;
+        }
+        baseStream.Flush(timeout);
+    }
+
+private:
+    /// @brief Writes `data` COBS encoded to the base stream, followed by the zero terminator.
+    void Encode(const uint8_t* data, size_t size, const Timeout& timeout) {
+        size_t pos = 0;
+        while (pos <= size) {
+            // A block is up to 254 non-zero bytes, prefixed with its length + 1
+            size_t run = 0;
+            while (run < 254 && pos + run < size && data[pos + run] != 0) {
+                run++;
+            }
+            uint8_t code = static_cast<uint8_t>(run + 1);
+            baseStream.Write(&code, 1, timeout);
+            baseStream.Write(data + pos, run, timeout);
+            pos += run;
+            if (run < 254) {
+                pos++; // Skip the zero the block stands for, or step past the end
+            }
+        }
+        uint8_t delimiter = 0;
+        baseStream.Write(&delimiter, 1, timeout);
+    }
+
+    /// @brief Receives and decodes frames from the base stream until a valid one arrives or the timeout expires.
+    /// @return True if a valid frame is in the receive buffer.
+    bool ReceiveFrame(const Timeout& timeout) {
+        ResetDecoder();
+        while (true) {
+            const uint8_t* window;
+            size_t available = baseStream.Peek(window, timeout);
+            if (available) {
+                // Decode the whole buffered chunk, stopping right after a complete frame
+                for (size_t i = 0; i < available; ++i) {
+                    if (DecodeByte(window[i])) {
+                        baseStream.Consume(i + 1);
+                        return true;
+                    }
+                }
+                baseStream.Consume(available);
+                continue;
+            }
+
+            uint8_t byte;
+            if (baseStream.Read(&byte, 1, timeout)) {
+                if (DecodeByte(byte)) {
+                    return true;
+                }
+            } else if (timeout.Expired()) {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Feeds one received byte to the COBS decoder.
+    /// @return True if the byte completed a valid frame, which is then ready in the receive buffer.
+    bool DecodeByte(uint8_t byte) {
+        if (byte == 0) {
+            // End of frame: the CRC over payload and CRC is zero for an intact frame
+            bool valid = !overflow && blockRemaining == 0 && decodedLength > CrcSize && decodedCrc == 0;
+            if (valid) {
+                rxLength = decodedLength - CrcSize;
+                rxPos = 0;
+            }
+            // Corrupted, truncated, oversized or empty frames are simply forgotten
+            ResetDecoder();
+            return valid;
+        }
+
+        if (blockRemaining == 0) {
+            // Code byte starting a new block
+            if (pendingZero) {
+                Store(0);
+            }
+            blockRemaining = byte - 1;
+            pendingZero = byte != 0xFF;
+            return false;
+        }
+
+        Store(byte);
+        blockRemaining--;
+        return false;
+    }
+
+    /// @brief Appends one decoded byte to the receive buffer and the running CRC.
+    void Store(uint8_t byte) {
+        if (decodedLength >= rxCapacity) {
+            overflow = true;
+            return;
+        }
+        rxBuffer[decodedLength++] = byte;
+        decodedCrc = Crc16Update(decodedCrc, byte);
+    }
+
+    /// @brief Prepares the decoder for the next frame.
+    void ResetDecoder() {
+        decodedLength = 0;
+        decodedCrc = Crc16Initial;
+        blockRemaining = 0;
+        pendingZero = false;
+        overflow = false;
+    }
+};
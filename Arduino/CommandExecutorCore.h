@@ -0,0 +1,555 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "Arena.h"
+#include "CommandList.h"
+#include "CompressedFraming.h"
+#include "Framing.h"
+#include "FrameStream.h"
+#include "JobTable.h"
+#include "NullStream.h"
+#include "ResponseCache.h"
+#include "CommandStats.h"
+#include "Scan.h"
+
+/// @brief The command execution logic shared by `CommandExecutor` and `StaticCommandExecutor`.
+/// It reads the requests of a frame, dispatches them and writes the responses, and holds the
+/// non-blocking, job and statistics state. The derived executor only decides how the framing of
+/// each frame is built, through a member `template <typename Body> void WithFraming(IStream&, Body&&)`
+/// that constructs a framing over the stream and calls `body` with it.
+/// @tparam Derived The executor deriving from this class.
+/// @tparam CommandListT The command list type; with a `final` list type lookups are direct calls.
+/// @tparam SerializerT The serializer type; with a `StaticSerializer` requests and responses are
+///         (de)serialized through direct calls.
+template <typename Derived, typename CommandListT, typename SerializerT>
+class CommandExecutorCore {
+    IStream& baseStream;                ///< Reference to the base `Stream` used for communication.
+    const CommandListT& commandList;   ///< Reference to the `CommandList` for command lookup.
+    SerializerT& serializer;           ///< Serializer for requests, responses and command arguments.
+
+    uint8_t* frameBuffer = nullptr;    ///< Collects incoming bytes in non-blocking mode, null in blocking mode.
+    size_t frameCapacity = 0;          ///< Size of `frameBuffer`.
+    size_t frameLength = 0;            ///< Bytes collected in `frameBuffer`.
+    size_t frameScanned = 0;           ///< Bytes of `frameBuffer` already searched for the delimiter.
+    uint8_t frameDelimiter = 0;        ///< Byte that ends a frame on the wire.
+    bool discarding = false;           ///< Dropping the rest of a frame that did not fit `frameBuffer`.
+
+    JobTable* jobTable = nullptr;      ///< Slots for asynchronous commands, null if jobs are not enabled.
+    LinkCompression* compression = nullptr; ///< Compression state switched by `BuiltinCompression`, or null.
+    ResponseCache* responseCache = nullptr; ///< Recorded outputs of cacheable commands, or null.
+    Arena* arena = nullptr;            ///< Holds the variable-length arguments of a frame, or null.
+    uint32_t requestBudgetUs = 0;      ///< Time each command may take, see `SetRequestBudget`; 0 for the `Tick` timeout.
+
+#if COMMANDKIT_STATS
+    CommandStats stats;                ///< Latency histograms and stage timings, see `BuiltinStats`.
+#endif
+
+public:
+    /// @brief The deadline of a command when neither a budget nor the `Tick` timeout leaves it any time.
+    static constexpr uint32_t DefaultRequestBudgetUs = 100000;
+
+    /// @brief Main loop function that builds the framing and then executes the commands of one frame.
+    /// This method builds the framing over the base stream, reads one frame within
+    /// the specified timeout and executes every request in it. All responses are sent back in one frame.
+    /// If no frame arrives before the timeout, nothing is written.
+    /// Running jobs, see `EnableJobs`, make progress first. The arena, see `EnableArena`, is reset last.
+    /// In non-blocking mode, see `EnableNonBlocking`, it only waits up to the timeout for new bytes and
+    /// executes a frame once all of it has arrived.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the command operation.
+    void Tick(const Timeout& timeout) {
+        if (jobTable) {
+            RunJobs(timeout);
+        }
+
+        if (frameBuffer) {
+            TickNonBlocking(timeout);
+        } else {
+            // Build the framing for this frame, as configured by the derived executor
+            Self().WithFraming(baseStream, [this, &timeout](Framing& framing) {
+                ServeFrame(framing, timeout);
+            });
+        }
+
+        if (arena) {
+            arena->Reset();
+        }
+    }
+
+    /// @brief Switches `Tick` to non-blocking operation.
+    /// Each `Tick` then takes whatever bytes have arrived, appends them to `buffer` and returns.
+    /// A partially received frame stays in the buffer until a later `Tick` sees its delimiter, so
+    /// `Tick(Timeout::Milliseconds(0))` never waits for the sender and the caller's loop keeps its
+    /// cycle time. Once a frame is complete it is executed from the buffer in the same `Tick`.
+    /// Frames larger than the buffer are dropped up to their delimiter without a response.
+    /// @param buffer Buffer collecting incoming frames; needs room for the largest encoded frame.
+    /// @param size Size of `buffer` in bytes.
+    /// @param delimiter The byte ending each frame on the wire: '\n' for `NewLineFraming`, 0 for `CobsFraming`.
+    void EnableNonBlocking(uint8_t* buffer, size_t size, uint8_t delimiter) {
+        frameBuffer = buffer;
+        frameCapacity = size;
+        frameLength = 0;
+        frameScanned = 0;
+        frameDelimiter = delimiter;
+        discarding = false;
+    }
+
+    /// @brief Enables asynchronous commands, those with a `job` function in their lookup item.
+    /// A job request is answered at once with the job handle and `Pending`. The job then makes
+    /// progress on every `Tick` while other requests keep being served. Streams are answered with
+    /// the handle and `Streaming`, and send their chunks as the client grants credits. How its result reaches
+    /// the client is set by the table's `JobCompletion` mode. Without a job table, job commands
+    /// are answered with `Busy`. A `Busy` job leaves its arguments unread, like an unknown command,
+    /// so clients that may exceed the table should send job requests last in a batch.
+    /// @param table The job slots, bounding the number of jobs running at once.
+    void EnableJobs(JobTable& table) {
+        jobTable = &table;
+    }
+
+    /// @brief Lets clients switch on compression with `BuiltinCompression`.
+    /// The framing factory must wrap each frame's framing in a `CompressedFraming` over the same state.
+    /// @param state The compression state of the connection.
+    void EnableCompression(LinkCompression& state) {
+        compression = &state;
+    }
+
+    /// @brief Gives every command a deadline of its own, returned by `ObjectStream::Deadline`.
+    /// The deadline starts once the request has been read. Without a budget commands get the
+    /// timeout passed to `Tick`, which in blocking mode also covers the wait for the frame. If that
+    /// has already run out, as with the `Tick(Timeout::Milliseconds(0))` of a non-blocking loop,
+    /// they get `DefaultRequestBudgetUs` instead.
+    /// @param microseconds The time each command may take, or 0 to use the `Tick` timeout.
+    void SetRequestBudget(uint32_t microseconds) {
+        requestBudgetUs = microseconds;
+    }
+
+    /// @brief Gives commands an arena for their variable-length arguments.
+    /// Commands read strings, blobs and arrays of any length with `ObjectStream::ReadString`,
+    /// `ReadBytes` and `ReadArray`, which place them in the arena; without one those reads fail.
+    /// The arena is reset at the end of every `Tick`, so it needs room for the arguments of the
+    /// largest frame, and a job must copy what it keeps into its state when it starts.
+    /// `Arena::HighWaterMark` shows how much of it was needed.
+    /// @param requestArena The arena, typically a `StaticArena`.
+    void EnableArena(Arena& requestArena) {
+        arena = &requestArena;
+    }
+
+    /// @brief Serves cacheable commands, those with an `epoch` in their lookup item, from a cache.
+    /// On a miss the command runs as usual and its outputs are recorded while they are sent; later
+    /// requests get the recorded bytes without calling the command, until its epoch changes.
+    /// Cacheable commands must not read arguments, as a cache hit leaves them unread.
+    /// @param cache The cache; its `Hits` and `Misses` count the requests for cacheable commands.
+    void EnableCache(ResponseCache& cache) {
+        responseCache = &cache;
+    }
+
+#if COMMANDKIT_STATS
+    /// @brief Returns the statistics collected so far. Only built with `COMMANDKIT_STATS`.
+    const CommandStats& Stats() const {
+        return stats;
+    }
+#endif
+
+protected:
+    /// @brief Constructs the executor state.
+    /// @param stream The base stream used for communication.
+    /// @param cmdList The command list for looking up and dispatching commands.
+    /// @param ser The serializer for requests, responses and command arguments.
+    CommandExecutorCore(IStream& stream, const CommandListT& cmdList, SerializerT& ser)
+        : baseStream(stream), commandList(cmdList), serializer(ser) {}
+
+private:
+    /// @brief Returns this object as the derived executor, which builds the framing.
+    Derived& Self() {
+        return static_cast<Derived&>(*this);
+    }
+
+    /// @brief Calls every pending job and open stream once and reports the ones that finish.
+    /// In `JobCompletion::Push` mode a finished job is sent at once in a frame of its own, laid out
+    /// like a response to its request, and its slot is freed. Streams send at most one chunk per
+    /// `Tick`, if they have a chunk ready and credit left, and always push their final result.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for sending chunks and completions.
+    void RunJobs(const Timeout& timeout) {
+        NullStream nullStream;
+        ObjectStream idle(nullStream, serializer);
+        for (JobContext& job : *jobTable) {
+            if (job.handle == 0 || (job.result != Pending && job.result != Streaming)) {
+                continue;
+            }
+
+            bool stream = job.result == Streaming;
+            job.phase = JobPhase::Run;
+            CommandResultCodes result = job.func(job, idle);
+            if (stream && (result == Pending || result == Streaming)) {
+                if (result == Streaming && job.credits > 0) {
+                    job.credits--;
+                    PushFrame(job, timeout, [&job](ObjectStream& objStream) {
+                        job.phase = JobPhase::Chunk;
+                        job.func(job, objStream);
+                        return Streaming;
+                    });
+                }
+                continue;
+            }
+
+            job.result = result;
+            if (result == Pending || (!stream && jobTable->Completion() != JobCompletion::Push)) {
+                continue;
+            }
+
+            PushFrame(job, timeout, [this, &job](ObjectStream& objStream) {
+                return ReportJob(job, objStream);
+            });
+        }
+    }
+
+    /// @brief Sends a frame on behalf of a job, laid out like a response to the request that started it.
+    /// @param job The job the frame belongs to.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for sending the frame.
+    /// @param body Called with an `ObjectStream` over the frame to write the outputs; returns the result to send.
+    template <typename Body>
+    void PushFrame(JobContext& job, const Timeout& timeout, Body&& body) {
+        uint32_t requestId = job.requestId; // The body may free the slot
+        Self().WithFraming(baseStream, [this, requestId, &timeout, &body](Framing& framing) {
+            ObjectStream objStream(framing, serializer);
+            serializer.Serialize(framing, ResponseHeader{requestId}, timeout);
+            CommandResultCodes result = body(objStream);
+            serializer.Serialize(framing, CommandResult{result, requestId}, timeout);
+            framing.Flush(timeout);
+        });
+    }
+
+    /// @brief Starts a job or stream for a request and answers with its handle.
+    /// @param func The job function of the command.
+    /// @param objStream An `ObjectStream` holding the job's arguments and receiving the handle.
+    /// @param request The request starting the job.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for writing the handle.
+    /// @return `Pending` if the job is running, `Streaming` if a stream was opened, `Busy` if no slot
+    ///         is free, or the result of a job that finished at once.
+    CommandResultCodes StartJob(JobFunc func, ObjectStream& objStream, const CommandRequest& request, const Timeout& timeout) {
+        JobContext* job = jobTable ? jobTable->Allocate(func, request.id) : nullptr;
+        if (!job) {
+            return Busy;
+        }
+
+        CommandResultCodes result = func(*job, objStream);
+        if (result != Pending && result != Streaming) {
+            jobTable->Release(*job); // Finished at once, its outputs are already written
+            return result;
+        }
+
+        job->result = result;
+        objStream.Write(static_cast<int>(job->handle), timeout);
+        return result;
+    }
+
+    /// @brief Executes `BuiltinJobStatus`: reads a job handle and reports the job if it has finished.
+    /// @param objStream An `ObjectStream` holding the handle and receiving the job's outputs.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for reading the handle.
+    /// @return `Pending` while the job runs, `Streaming` for an open stream, the job's result once it
+    ///         has finished, or `JobNotFound`.
+    CommandResultCodes JobStatus(ObjectStream& objStream, const Timeout& timeout) {
+        JobContext* job;
+        CommandResultCodes result = ReadJob(objStream, job, timeout);
+        if (result != Ok) {
+            return result;
+        }
+        return job->result == Pending || job->result == Streaming ? job->result : ReportJob(*job, objStream);
+    }
+
+    /// @brief Executes `BuiltinStreamCredit`: reads a stream's handle and the number of chunks it may send.
+    /// @param objStream An `ObjectStream` holding the handle and the count.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for reading the arguments.
+    /// @return `Ok`, `SerializeError` if the arguments could not be read, or `JobNotFound` if no stream has the handle.
+    CommandResultCodes GrantCredits(ObjectStream& objStream, const Timeout& timeout) {
+        int handle, credits;
+        if (!objStream.Read(handle, timeout) || !objStream.Read(credits, timeout) || credits < 0) {
+            return SerializeError;
+        }
+
+        JobContext* job = jobTable->Find(static_cast<uint32_t>(handle));
+        if (!job || job->result != Streaming) {
+            return JobNotFound;
+        }
+
+        job->AddCredits(static_cast<uint32_t>(credits));
+        return Ok;
+    }
+
+    /// @brief Executes `BuiltinJobCancel`: reads a job handle and frees the job's slot without reporting it.
+    /// @param objStream An `ObjectStream` holding the handle.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for reading the handle.
+    /// @return `Ok`, `SerializeError` if the handle could not be read, or `JobNotFound`.
+    CommandResultCodes CancelJob(ObjectStream& objStream, const Timeout& timeout) {
+        JobContext* job;
+        CommandResultCodes result = ReadJob(objStream, job, timeout);
+        if (result == Ok) {
+            jobTable->Release(*job);
+        }
+        return result;
+    }
+
+    /// @brief Sends the recorded outputs of a cacheable command, or runs it and records them.
+    /// @param item The lookup item of the command, with an `epoch`.
+    /// @param framing The framing the outputs are written to.
+    /// @param objStream The `ObjectStream` of the frame, holding the request's deadline.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for writing recorded outputs.
+    /// @return `Ok` for a cache hit, otherwise the command's result.
+    CommandResultCodes ExecuteCached(const CommandLookupItem& item, Framing& framing, ObjectStream& objStream,
+                                     const Timeout& timeout) {
+        uint32_t epoch = *item.epoch; // Read first, a change while the command runs makes the recording stale
+        if (const CachedResponse* hit = responseCache->Find(item.cmd, epoch)) {
+            framing.Write(responseCache->Bytes(*hit), hit->length, timeout);
+            return Ok;
+        }
+
+        CachedResponse& slot = responseCache->Claim(item.cmd);
+        ResponseRecorder recorder(framing, responseCache->Bytes(slot), responseCache->SlotSize());
+        ObjectStream recording(recorder, serializer);
+        recording.SetDeadline(&objStream.Deadline());
+        CommandResultCodes result = item.execute(recording);
+        if (result == Ok && recorder.Complete()) {
+            responseCache->Store(slot, epoch, recorder.Length());
+        }
+        return result;
+    }
+
+    /// @brief Executes `BuiltinCompression`: reads the codec version and switches compression
+    /// once the response has been sent.
+    /// @return `Ok`, `SerializeError` if the version could not be read, or `GeneralError` for an unknown version.
+    CommandResultCodes SetCompression(ObjectStream& objStream, const Timeout& timeout) {
+        int version;
+        if (!objStream.Read(version, timeout)) {
+            return SerializeError;
+        }
+        if (version != 0 && version != LzCodecVersion) {
+            return GeneralError;
+        }
+        compression->next = version != 0;
+        return Ok;
+    }
+
+    /// @brief Executes `BuiltinDescribe`: reads a command code and writes the command's schema.
+    /// @return `Ok`, `SerializeError` if the code could not be read, `CommandNotFound`, or
+    ///         `GeneralError` if the command has no schema.
+    CommandResultCodes Describe(ObjectStream& objStream, const Timeout& timeout) {
+        unsigned int cmd;
+        if (!objStream.Read(cmd, timeout)) {
+            return SerializeError;
+        }
+
+        const CommandLookupItem* item = commandList.Find(cmd);
+        if (!item) {
+            return CommandNotFound;
+        }
+        if (!item->schema) {
+            return GeneralError;
+        }
+        return objStream.WriteArray(item->schema + 1, item->schema[0], timeout) ? Ok : SerializeError;
+    }
+
+    /// @brief Reads a job handle and finds its job.
+    /// @param objStream An `ObjectStream` holding the handle.
+    /// @param job Set to the job with the handle.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for reading the handle.
+    /// @return `Ok`, `SerializeError` if the handle could not be read, or `JobNotFound`.
+    CommandResultCodes ReadJob(ObjectStream& objStream, JobContext*& job, const Timeout& timeout) {
+        int handle;
+        if (!objStream.Read(handle, timeout)) {
+            return SerializeError;
+        }
+
+        job = jobTable->Find(static_cast<uint32_t>(handle));
+        return job ? Ok : JobNotFound;
+    }
+
+    /// @brief Lets a finished job write its outputs, then frees its slot.
+    /// @return The job's final result.
+    CommandResultCodes ReportJob(JobContext& job, ObjectStream& objStream) {
+        job.phase = JobPhase::Report;
+        job.func(job, objStream);
+        jobTable->Release(job);
+        return job.result;
+    }
+
+    /// @brief One non-blocking step: collects the bytes that have arrived and executes at most one complete frame.
+    /// Further complete frames left in the buffer are executed by the following ticks.
+    /// @param timeout A `Timeout` object bounding the wait for new bytes and the execution of a complete frame.
+    void TickNonBlocking(const Timeout& timeout) {
+        // A frame that arrived together with the previous one is served without waiting for more bytes
+        const uint8_t* end = FindByte(frameBuffer + frameScanned, frameLength - frameScanned, frameDelimiter);
+        if (!end && frameLength < frameCapacity) {
+            // Only the newly arrived bytes need to be searched
+            frameScanned = frameLength;
+            frameLength += baseStream.Read(frameBuffer + frameLength, frameCapacity - frameLength, timeout);
+            end = FindByte(frameBuffer + frameScanned, frameLength - frameScanned, frameDelimiter);
+        }
+        if (!end) {
+            frameScanned = frameLength;
+            if (frameLength == frameCapacity) {
+                // The frame does not fit, drop what we have and skip ahead to its delimiter
+                frameLength = 0;
+                frameScanned = 0;
+                discarding = true;
+            }
+            return;
+        }
+
+        size_t size = end - frameBuffer + 1;
+        if (discarding) {
+            discarding = false; // Tail of an oversized frame
+        } else {
+            FrameStream frameStream(frameBuffer, size, baseStream);
+            Self().WithFraming(frameStream, [this, &timeout](Framing& framing) {
+                ServeFrame(framing, timeout);
+            });
+        }
+
+        // Keep the start of the next frame, if it arrived together with this one
+        memmove(frameBuffer, frameBuffer + size, frameLength - size);
+        frameLength -= size;
+        frameScanned = 0;
+    }
+
+    /// @brief Executes the requests of one frame and flushes the responses.
+    /// @param framing The framing of the incoming frame, which also carries the responses.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read and write operations.
+    void ServeFrame(Framing& framing, const Timeout& timeout) {
+        ObjectStream objStream(framing, serializer);
+        objStream.SetArena(arena);
+        ExecuteFrame(framing, objStream, timeout);
+#if COMMANDKIT_STATS
+        uint32_t flushStart = CommandStats::Now();
+#endif
+        framing.Flush(timeout);
+#if COMMANDKIT_STATS
+        stats.AddStage(CommandStage::Flush, CommandStats::Now() - flushStart);
+#endif
+    }
+
+    /// @brief Executes the batch of requests in one frame, in order.
+    /// A frame holds one or more requests, each followed by the arguments its command reads.
+    /// Reading stops at the end of the frame. A request that cannot be read is answered with
+    /// `SerializeError` and ends the batch, as the rest of the frame can no longer be parsed.
+    /// So does a request that fails with any result other than `Ok`, `Pending` or `Streaming`: its
+    /// command may not have read all of its arguments, which would otherwise be read as requests.
+    /// The rest of the frame is then discarded unanswered.
+    /// @param framing The framing the requests are read from, used to detect the end of the frame.
+    /// @param objStream An `ObjectStream` used for reading and writing serialized data.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read and write operations.
+    void ExecuteFrame(Framing& framing, ObjectStream& objStream, const Timeout& timeout) {
+        size_t handled = 0;
+        do {
+            CommandRequest request{};
+#if COMMANDKIT_STATS
+            uint32_t readStart = CommandStats::Now();
+#endif
+            if (!serializer.Deserialize(framing, request, timeout)) { // Use timeout provided
+                if (framing.FramePosition() == 0) {
+                    return; // No frame arrived, or an empty one
+                }
+                if (handled > 0 && framing.EndOfFrame()) {
+                    return; // Only separators after the last request
+                }
+                serializer.Serialize(framing, ResponseHeader{request.id}, Timeout::Milliseconds(100));
+                serializer.Serialize(framing, CommandResult::Error(CommandResultCodes::SerializeError, request.id), Timeout::Milliseconds(100)); // Write with timeout
+                return;
+            }
+
+#if COMMANDKIT_STATS
+            stats.AddStage(CommandStage::Read, CommandStats::Now() - readStart);
+#endif
+            CommandResultCodes result = ExecuteCommand(framing, objStream, request, timeout);
+            handled++;
+            if (result != Ok && result != Pending && result != Streaming) {
+                DiscardFrame(framing, timeout);
+                return;
+            }
+        } while (!framing.EndOfFrame());
+    }
+
+    /// @brief Reads and drops the rest of the current frame.
+    void DiscardFrame(Framing& framing, const Timeout& timeout) {
+        uint8_t scratch[16];
+        while (!framing.EndOfFrame() && framing.Read(scratch, sizeof(scratch), timeout)) {
+        }
+    }
+
+    /// @brief Looks up a command request in the command list and executes it.
+    /// The response starts with a `ResponseHeader` carrying the request id, followed by whatever the
+    /// command writes, and ends with the `CommandResult`. Unknown commands are answered with `CommandNotFound`.
+    /// Job commands are started instead, see `EnableJobs`, and built-in commands are served by the executor.
+    /// @param framing The framing the response is written to.
+    /// @param objStream An `ObjectStream` over `framing`, passed to the command.
+    /// @param request The request to execute.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read and write operations.
+    /// @return The result the request was answered with.
+    CommandResultCodes ExecuteCommand(Framing& framing, ObjectStream& objStream, const CommandRequest& request, const Timeout& timeout) {
+#if COMMANDKIT_STATS
+        uint32_t lookupStart = CommandStats::Now();
+#endif
+        // Lookup and execute the command
+        const CommandLookupItem* item = commandList.Find(request.cmd);
+#if COMMANDKIT_STATS
+        uint32_t writeStart = CommandStats::Now();
+#endif
+        serializer.Serialize(framing, ResponseHeader{request.id}, timeout);
+
+#if COMMANDKIT_STATS
+        uint32_t executeStart = CommandStats::Now();
+#endif
+        Timeout deadline = requestBudgetUs ? Timeout::Microseconds(requestBudgetUs)
+                         : timeout.Expired() ? Timeout::Microseconds(DefaultRequestBudgetUs)
+                                             : timeout;
+        objStream.SetDeadline(&deadline);
+        CommandResultCodes result = CommandNotFound; // Error for unknown command
+        if (item && item->job) {
+            result = StartJob(item->job, objStream, request, timeout);
+        } else if (item && item->execute && item->epoch && responseCache) {
+            result = ExecuteCached(*item, framing, objStream, timeout);
+        } else if (item && item->execute) {
+            result = item->execute(objStream); // Execute command
+        } else if (request.cmd == BuiltinJobStatus && jobTable) {
+            result = JobStatus(objStream, timeout);
+        } else if (request.cmd == BuiltinStreamCredit && jobTable) {
+            result = GrantCredits(objStream, timeout);
+        } else if (request.cmd == BuiltinJobCancel && jobTable) {
+            result = CancelJob(objStream, timeout);
+        } else if (request.cmd == BuiltinCompression && compression) {
+            result = SetCompression(objStream, timeout);
+        } else if (request.cmd == BuiltinDescribe) {
+            result = Describe(objStream, timeout);
+        }
+#if COMMANDKIT_STATS
+        else if (request.cmd == BuiltinStats) {
+            result = WriteStats(objStream, timeout);
+        }
+        uint32_t executeEnd = CommandStats::Now();
+#endif
+        objStream.SetDeadline(nullptr);
+        serializer.Serialize(framing, CommandResult{result, request.id}, timeout); // Write result back to stream
+
+#if COMMANDKIT_STATS
+        uint32_t writeEnd = CommandStats::Now();
+        stats.AddStage(CommandStage::Lookup, writeStart - lookupStart);
+        stats.AddStage(CommandStage::Execute, executeEnd - executeStart);
+        stats.AddStage(CommandStage::Write, (executeStart - writeStart) + (writeEnd - executeEnd));
+        stats.RecordCommand(request.cmd, result, executeEnd - executeStart);
+#endif
+        return result;
+    }
+
+#if COMMANDKIT_STATS
+    /// @brief Executes `BuiltinStats`: writes the statistics and clears them if asked to.
+    /// @return `Ok`, or `SerializeError` if the argument could not be read or the statistics written.
+    CommandResultCodes WriteStats(ObjectStream& objStream, const Timeout& timeout) {
+        int reset;
+        if (!objStream.Read(reset, timeout) || !stats.Write(objStream, timeout)) {
+            return SerializeError;
+        }
+        if (reset) {
+            stats.Reset();
+        }
+        return Ok;
+    }
+#endif
+};
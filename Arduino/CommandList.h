@@ -4,6 +4,7 @@
 #include "ObjectStream.h"
 #include "CommandStructures.h"
 #include "Timeout.h"
+#include "JobTable.h"
 
 /// @brief Type alias for a command function pointer.
 /// A command function takes an `ObjectStream` reference as an argument
@@ -12,28 +13,45 @@
 /// @return A `CommandResultCodes` value representing the command's success or failure.
 using CommandFunc = CommandResultCodes (*)(ObjectStream& objStream);
 
+// CommandLookupItem structure for command lookup.
+// Plain commands set `execute`; asynchronous commands leave it null and set `job` instead.
+// Plain commands without arguments whose outputs only change with some state may set `epoch` to a
+// counter that the application increments whenever that state changes. With a `ResponseCache`
+// enabled, the executor then replays their recorded outputs instead of calling them.
+// `schema` describes the arguments and outputs for `BuiltinDescribe`; `Command` fills it in for
+// typed commands, see TypedCommand.h.
+struct CommandLookupItem {
+    uint32_t cmd;
+    CommandFunc execute;
+    JobFunc job = nullptr;
+    const uint32_t* epoch = nullptr;
+    const uint16_t* schema = nullptr;
+};
+
 /// @brief An interface for command lookup functionality in a command list.
 /// This interface is designed to resolve command codes to their associated
 /// functions, enabling dynamic dispatch of commands in a system.
 class CommandList {
 public:
+    /// @brief Finds the lookup item of a command code.
+    /// @param cmd The command code used to identify the command.
+    /// @return The lookup item of the command, or nullptr if the command is not found.
+    virtual const CommandLookupItem* Find(uint32_t cmd) const = 0;
+
     /// @brief Looks up a command function based on a command code.
     /// @param cmd The command code used to identify the function.
     /// @return A function pointer to the command handler associated with the command code.
-    ///         Returns nullptr if the command is not found.
-    virtual CommandFunc Lookup(uint32_t cmd) const = 0;
-};
-
-// CommandLookupItem structure for command lookup
-struct CommandLookupItem {
-    uint32_t cmd;
-    CommandFunc execute;
+    ///         Returns nullptr if the command is not found or is a job.
+    CommandFunc Lookup(uint32_t cmd) const {
+        const CommandLookupItem* item = Find(cmd);
+        return item ? item->execute : nullptr;
+    }
 };
 
 
 /// @brief A concrete class implementing a static command list using a lookup table provided at construction.
 /// This class performs a compile-time command lookup, allowing flexible initialization of command lists.
-class StaticCommandList : public CommandList {
+class StaticCommandList final : public CommandList {
     const CommandLookupItem* commandTable;  ///< Pointer to the array of command lookup items.
     const size_t commandTableSize;          ///< The number of entries in the command lookup table.
 
@@ -44,16 +62,86 @@ public:
     StaticCommandList(const CommandLookupItem* table, size_t size) 
         : commandTable(table), commandTableSize(size) {}
 
-    /// @brief Looks up a command function based on a command code.
-    /// @param cmd The command code used to identify the function.
-    /// @return A function pointer to the command handler associated with the command code.
-    ///         Returns nullptr if the command is not found.
-    CommandFunc Lookup(uint32_t cmd) const override {
+    /// @brief Finds the lookup item of a command code.
+    /// @param cmd The command code used to identify the command.
+    /// @return The lookup item of the command, or nullptr if the command is not found.
+    const CommandLookupItem* Find(uint32_t cmd) const override {
         for (size_t i = 0; i < commandTableSize; ++i) {
             if (commandTable[i].cmd == cmd) {
-                return commandTable[i].execute;
+                return &commandTable[i];
             }
         }
         return nullptr; // Command not found
     }
-};
\ No newline at end of file
+};
+
+
+// Deliberately not constexpr: reaching it while building a constexpr command list is a compile error
+inline void DuplicateCommandId() {}
+
+/// @brief A command list built at compile time from a lookup table, with constant or logarithmic lookup.
+/// The table is copied and sorted by command code when the list is constructed. If the codes form a
+/// contiguous range, `Find` indexes the table directly; otherwise it does a binary search.
+/// Declare instances `constexpr` (see `MakeCommandList`) so duplicate command codes are rejected at compile time.
+/// @tparam N The number of entries in the table.
+template <size_t N>
+class ConstexprCommandList final : public CommandList {
+    static_assert(N > 0, "A command list needs at least one command");
+
+    CommandLookupItem commandTable[N]; ///< The lookup items, sorted by command code.
+    bool dense;                        ///< True if the command codes are contiguous.
+
+public:
+    /// @brief Constructs the list from a lookup table in any order.
+    /// @param table The command lookup items. Command codes must be unique.
+    constexpr ConstexprCommandList(const CommandLookupItem (&table)[N])
+        : commandTable{}, dense(false) {
+        for (size_t i = 0; i < N; ++i) {
+            // Insertion sort, tables are small and this runs at compile time
+            CommandLookupItem item = table[i];
+            size_t j = i;
+            while (j > 0 && commandTable[j - 1].cmd > item.cmd) {
+                commandTable[j] = commandTable[j - 1];
+                --j;
+            }
+            commandTable[j] = item;
+        }
+
+        for (size_t i = 1; i < N; ++i) {
+            if (commandTable[i].cmd == commandTable[i - 1].cmd) {
+                DuplicateCommandId();
+            }
+        }
+
+        dense = commandTable[N - 1].cmd - commandTable[0].cmd == N - 1;
+    }
+
+    /// @brief Finds the lookup item of a command code.
+    /// @param cmd The command code used to identify the command.
+    /// @return The lookup item of the command, or nullptr if the command is not found.
+    const CommandLookupItem* Find(uint32_t cmd) const override {
+        if (dense) {
+            uint32_t index = cmd - commandTable[0].cmd; // Wraps for codes below the range
+            return index < N ? &commandTable[index] : nullptr;
+        }
+
+        // Branchless lower bound, the comparison result only selects the next base
+        const CommandLookupItem* base = commandTable;
+        size_t length = N;
+        while (length > 1) {
+            size_t half = length / 2;
+            base = base[half].cmd < cmd ? base + half : base;
+            length -= half;
+        }
+        base += base->cmd < cmd;
+        return base < commandTable + N && base->cmd == cmd ? base : nullptr;
+    }
+};
+
+/// @brief Creates a `ConstexprCommandList` from a lookup table, deducing its size.
+/// @param table The command lookup items. Command codes must be unique.
+/// @return The command list; assign it to a `constexpr` variable to check the table at compile time.
+template <size_t N>
+constexpr ConstexprCommandList<N> MakeCommandList(const CommandLookupItem (&table)[N]) {
+    return ConstexprCommandList<N>(table);
+}
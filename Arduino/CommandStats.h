@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Clock.h"
+#include "ObjectStream.h"
+#include "CommandStructures.h"
+
+/// @file CommandStats.h
+/// @brief Optional latency and call statistics for the `CommandExecutor`.
+/// Define `COMMANDKIT_STATS` as 1 before including `CommandExecutor.h` (or on the compiler command
+/// line) to enable them. When it is 0, the default, the executor contains no statistics code or data.
+
+#ifndef COMMANDKIT_STATS
+#define COMMANDKIT_STATS 0
+#endif
+
+/// Number of distinct command codes tracked; further commands are only counted as dropped.
+#ifndef COMMANDKIT_STATS_COMMANDS
+#define COMMANDKIT_STATS_COMMANDS 8
+#endif
+
+/// @brief Number of latency histogram buckets per command.
+/// Bucket 0 counts calls under 1 us, bucket i calls of [2^(i-1), 2^i) us, the last one everything longer.
+constexpr size_t StatsBuckets = 16;
+
+/// @brief The stages of executing a request, timed separately.
+enum class CommandStage : uint8_t {
+    Read,     ///< Reading the request. In blocking mode this includes waiting for the frame.
+    Lookup,   ///< Finding the command in the command list.
+    Execute,  ///< Running the command, including its own argument reads and output writes.
+    Write,    ///< Writing the response header and result.
+    Flush,    ///< Flushing the response frame.
+    Count
+};
+
+/// @brief Statistics of one command code.
+struct CommandStatsEntry {
+    uint32_t cmd;                     ///< The command code.
+    uint32_t calls;                   ///< Number of executions.
+    uint32_t errors;                  ///< Executions with a result other than `Ok`, `Pending` or `Streaming`.
+    uint16_t buckets[StatsBuckets];   ///< Execution time histogram, saturating at 65535.
+};
+
+/// @brief Fixed-size per-command latency histograms, call and error counters, and stage timings.
+/// Command codes get an entry on their first call; once all entries are in use, calls of further
+/// codes are counted as dropped. Times are taken with `TimeoutClock` and wrap like it does.
+class CommandStats {
+    CommandStatsEntry entries[COMMANDKIT_STATS_COMMANDS] = {}; ///< One entry per command code seen.
+    size_t used = 0;                                           ///< Entries in use.
+    uint32_t dropped = 0;                                      ///< Calls of commands without an entry.
+    uint32_t stageMicros[static_cast<size_t>(CommandStage::Count)] = {}; ///< Total time per stage.
+
+public:
+    /// @brief Returns the current time for stage and command timing.
+    static uint32_t Now() {
+        return TimeoutClock::Now();
+    }
+
+    /// @brief Adds time spent in a stage.
+    void AddStage(CommandStage stage, uint32_t elapsedMicros) {
+        stageMicros[static_cast<size_t>(stage)] += elapsedMicros;
+    }
+
+    /// @brief Records one execution of a command.
+    /// @param cmd The command code.
+    /// @param result The result of the command.
+    /// @param elapsedMicros The execution time in microseconds.
+    void RecordCommand(uint32_t cmd, CommandResultCodes result, uint32_t elapsedMicros) {
+        CommandStatsEntry* entry = FindEntry(cmd);
+        if (!entry) {
+            dropped++;
+            return;
+        }
+        entry->calls++;
+        if (result != Ok && result != Pending && result != Streaming) {
+            entry->errors++;
+        }
+        uint16_t& bucket = entry->buckets[Bucket(elapsedMicros)];
+        if (bucket != UINT16_MAX) {
+            bucket++;
+        }
+    }
+
+    /// @brief Writes all statistics to a stream, as ints.
+    /// The layout is: the number of buckets, the total microseconds of each `CommandStage` in order,
+    /// the dropped call count and the number of entries, then per entry its command code, calls,
+    /// errors and bucket counts.
+    /// @return True if everything was written.
+    bool Write(ObjectStream& objStream, const Timeout& timeout) const {
+        bool ok = objStream.Write(static_cast<int>(StatsBuckets), timeout);
+        for (uint32_t total : stageMicros) {
+            ok = ok && objStream.Write(static_cast<int>(total), timeout);
+        }
+        ok = ok && objStream.Write(static_cast<int>(dropped), timeout);
+        ok = ok && objStream.Write(static_cast<int>(used), timeout);
+        for (size_t i = 0; i < used && ok; ++i) {
+            const CommandStatsEntry& entry = entries[i];
+            ok = objStream.Write(static_cast<int>(entry.cmd), timeout) &&
+                 objStream.Write(static_cast<int>(entry.calls), timeout) &&
+                 objStream.Write(static_cast<int>(entry.errors), timeout);
+            for (uint16_t count : entry.buckets) {
+                ok = ok && objStream.Write(static_cast<int>(count), timeout);
+            }
+        }
+        return ok;
+    }
+
+    /// @brief Clears all statistics.
+    void Reset() {
+        *this = CommandStats();
+    }
+
+    /// @brief Returns the entries in use, in order of first call.
+    const CommandStatsEntry* begin() const { return entries; }
+    const CommandStatsEntry* end() const { return entries + used; }
+
+    /// @brief Returns the total microseconds spent in a stage.
+    uint32_t StageMicros(CommandStage stage) const { return stageMicros[static_cast<size_t>(stage)]; }
+
+    /// @brief Returns the number of calls of commands that did not get an entry.
+    uint32_t Dropped() const { return dropped; }
+
+private:
+    /// @brief Finds the entry of a command code, claiming a free one on its first call.
+    CommandStatsEntry* FindEntry(uint32_t cmd) {
+        for (size_t i = 0; i < used; ++i) {
+            if (entries[i].cmd == cmd) {
+                return &entries[i];
+            }
+        }
+        if (used == COMMANDKIT_STATS_COMMANDS) {
+            return nullptr;
+        }
+        entries[used].cmd = cmd;
+        return &entries[used++];
+    }
+
+    /// @brief Returns the histogram bucket of a duration: its bit width, capped at the last bucket.
+    static size_t Bucket(uint32_t elapsedMicros) {
+        size_t width = 0;
+        while (elapsedMicros && width < StatsBuckets - 1) {
+            elapsedMicros >>= 1;
+            width++;
+        }
+        return width;
+    }
+};
@@ -9,12 +9,57 @@ enum CommandResultCodes {
     GeneralError = 1,    ///< Indicates a general error occurred during command execution.
     SerializeError = 2,  ///< Indicates a failure occurred during the serialization or deserialization of data.
     CommandNotFound = 3, ///< Indicates that the specified command was not found in the command list.
+    Pending = 4,         ///< The command was started as a job and is still running; see `JobTable`.
+    Busy = 5,            ///< A job could not be started because every job slot is in use.
+    JobNotFound = 6,     ///< The job handle does not belong to a running or finished job.
+    Streaming = 7,       ///< The command was started as a stream and more chunks follow; see `JobTable`.
+    TimedOut = 8,        ///< Client side only: no response arrived before the request's timeout.
+    BatchAborted = 9,    ///< Client side only: an earlier request in the same frame failed, so this one was not executed.
+};
+
+/// @brief Command codes reserved for commands built into the `CommandExecutor`.
+/// They sit at the top of the code space, clear of application command tables.
+enum BuiltinCommands : uint32_t {
+    /// Takes a job handle. Answers `Pending` while the job runs; once it has finished, answers
+    /// with the job's outputs and final result and releases the handle.
+    BuiltinJobStatus = 0xFFFFFF00,
+
+    /// Takes an int; if it is non-zero the statistics are cleared after being sent. Answers with
+    /// the executor's statistics, see `CommandStats::Write`. Only built with `COMMANDKIT_STATS`.
+    BuiltinStats = 0xFFFFFF01,
+
+    /// Takes a stream's job handle and a count. Allows the stream to send that many more chunks.
+    /// Answers `Ok`, or `JobNotFound` if the handle does not belong to an open stream.
+    BuiltinStreamCredit = 0xFFFFFF02,
+
+    /// Takes a job handle. Stops the job or stream without reporting it and frees its slot.
+    /// Answers `Ok`, or `JobNotFound` if the handle does not belong to a job.
+    BuiltinJobCancel = 0xFFFFFF03,
+
+    /// Takes an int: the `LzCodecVersion` the client decodes, or 0 to stop compressing. Answers
+    /// `Ok` uncompressed and switches the connection from the next frame on, or `GeneralError`
+    /// for an unknown version. Only served once enabled with `EnableCompression`.
+    BuiltinCompression = 0xFFFFFF04,
+
+    /// Takes a command code as an unsigned int. Answers with the command's schema, an array of
+    /// uint16_t entries as described in TypedCommand.h, or `CommandNotFound` for an unknown code
+    /// and `GeneralError` for a command without a schema.
+    BuiltinDescribe = 0xFFFFFF05,
 };
 
 /// @brief Structure representing a command request.
 /// This structure contains information about the command to be executed.
+/// Several requests may be sent in one frame; they are answered in order, in one response frame.
 struct CommandRequest {
     uint32_t cmd;  ///< Command identifier (code) representing the requested command.
+    uint32_t id;   ///< Correlation id chosen by the client, echoed in the response. Formats without ids use 0.
+};
+
+/// @brief Structure written at the start of each response, before any output of the command.
+/// It lets a client that keeps several requests in flight match the response to its request
+/// before parsing the command's output.
+struct ResponseHeader {
+    uint32_t id;   ///< The id of the request this response answers.
 };
 
 /// @brief Structure representing the result of a command execution.
@@ -22,6 +67,7 @@ struct CommandRequest {
 /// and provides static methods for generating common result types.
 struct CommandResult {
     CommandResultCodes resultCode; ///< The result code of the command execution (OK or Error).
+    uint32_t id;                   ///< The id of the request this result belongs to.
 
     /// @brief Creates a `CommandResult` representing a successful command execution.
     /// @return A `CommandResult` with the result code set to `CommandResultCodes::OK`.
@@ -29,6 +75,7 @@ struct CommandResult {
 
     /// @brief Creates a `CommandResult` representing a failed command execution.
     /// @param code A `CommandResultCodes` value indicating the specific error.
+    /// @param id The id of the request that failed.
     /// @return A `CommandResult` with the result code set to the specified error code.
-    static CommandResult Error(CommandResultCodes code) { return CommandResult{code}; }
+    static CommandResult Error(CommandResultCodes code, uint32_t id = 0) { return CommandResult{code, id}; }
 };
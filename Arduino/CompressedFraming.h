@@ -0,0 +1,158 @@
+#pragma once
+#include <cstring>
+#include "Framing.h"
+#include "LzCodec.h"
+
+/// @brief The version of the `LzCodec` coding and dictionary, as negotiated with `BuiltinCompression`.
+constexpr int LzCodecVersion = 1;
+
+/// @brief Whether the frames of one connection are compressed, shared by all its framings.
+/// Both ends start uncompressed. The client asks with `BuiltinCompression`; the executor answers
+/// uncompressed and compresses from the next frame on, in both directions. The client switches
+/// once it has the answer, so it must not send further requests before then.
+struct LinkCompression {
+    bool enabled = false;  ///< Frames are compressed in both directions.
+    bool next = false;     ///< The value `enabled` takes once the frame being written has been sent.
+
+    /// @brief Switches compression on or off at once, as the client does after the answer.
+    void Set(bool on) {
+        enabled = on;
+        next = on;
+    }
+};
+
+/// @brief A `Framing` decorator that compresses frames with `LzCodec` while the connection's
+/// `LinkCompression` is enabled, and passes them through unchanged otherwise.
+/// The inner framing delimits and checks the coded frames as before. An incoming frame is decoded
+/// into the receive buffer as a whole before it is read; an outgoing frame is collected in the
+/// transmit buffer and coded on `Flush`. A frame that fails to decode is dropped like a frame
+/// with a bad CRC.
+///
+/// Construct one per frame over the framing built for that frame, for example in the
+/// `FramingFactory` of a `CommandExecutor`.
+class CompressedFraming : public Framing {
+    Framing& inner;           ///< The framing carrying the coded frames.
+    LinkCompression& state;
+
+    uint8_t* rxBuffer;        ///< Receives the decoded frame.
+    size_t rxCapacity;
+    size_t rxLength = 0;      ///< Decoded length of the current frame.
+    size_t rxPos = 0;         ///< Read position within the decoded frame.
+    bool decoded = false;     ///< Set once the current frame has been received and decoded.
+
+    uint8_t* txBuffer;        ///< Collects the outgoing frame before it is coded.
+    size_t txCapacity;
+    size_t txLength = 0;
+
+public:
+    /// @brief Constructs the decorator over the framing of one frame.
+    /// @param framing The framing carrying the coded frames.
+    /// @param compression The compression state of the connection.
+    /// @param rxBuf Buffer receiving the decoded frame; needs room for the largest incoming payload.
+    /// @param rxSize Size of `rxBuf` in bytes.
+    /// @param txBuf Buffer collecting the outgoing frame; needs room for the largest outgoing payload.
+    /// @param txSize Size of `txBuf` in bytes.
+    CompressedFraming(Framing& framing, LinkCompression& compression, uint8_t* rxBuf, size_t rxSize,
+                      uint8_t* txBuf, size_t txSize)
+        : Framing(framing), inner(framing), state(compression), rxBuffer(rxBuf), rxCapacity(rxSize),
+          txBuffer(txBuf), txCapacity(txSize) {}
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        if (!state.enabled) {
+            return inner.Read(data, size, timeout);
+        }
+        const uint8_t* window;
+        size_t available = Peek(window, timeout);
+        size_t count = size < available ? size : available;
+        memcpy(data, window, count);
+        rxPos += count;
+        return count;
+    }
+
+    /// @brief Exposes the unread part of the decoded frame, receiving and decoding it first if needed.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        if (!state.enabled) {
+            return inner.Peek(data, timeout);
+        }
+        if (!decoded) {
+            Decode(timeout);
+        }
+        data = rxBuffer + rxPos;
+        return rxLength - rxPos;
+    }
+
+    virtual void Consume(size_t size) override {
+        if (!state.enabled) {
+            inner.Consume(size);
+            return;
+        }
+        rxPos += size;
+    }
+
+    virtual bool EndOfFrame() const override {
+        return state.enabled ? decoded && rxPos >= rxLength : inner.EndOfFrame();
+    }
+
+    virtual size_t FramePosition() const override {
+        return state.enabled ? rxPos : inner.FramePosition();
+    }
+
+    /// @brief Appends data to the outgoing frame.
+    /// @return The number of bytes accepted; fewer than `size` once the transmit buffer is full.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        if (!state.enabled) {
+            return inner.Write(data, size, timeout);
+        }
+        size_t space = txCapacity - txLength;
+        size_t count = size < space ? size : space;
+        memcpy(txBuffer + txLength, data, count);
+        txLength += count;
+        return count;
+    }
+
+    /// @brief Codes and sends the outgoing frame, then applies a compression change requested
+    /// while this frame was served.
+    virtual void Flush(const Timeout& timeout) override {
+        if (state.enabled && txLength) {
+            uint8_t chunk[32];
+            size_t used = 0;
+            LzEncode(txBuffer, txLength, [&](const uint8_t* data, size_t size) {
+                while (size) {
+                    size_t count = size < sizeof(chunk) - used ? size : sizeof(chunk) - used;
+                    memcpy(chunk + used, data, count);
+                    used += count;
+                    data += count;
+                    size -= count;
+                    if (used == sizeof(chunk)) {
+                        inner.Write(chunk, used, timeout);
+                        used = 0;
+                    }
+                }
+            });
+            if (used) {
+                inner.Write(chunk, used, timeout);
+            }
+            txLength = 0;
+        }
+        inner.Flush(timeout);
+        state.enabled = state.next;
+    }
+
+private:
+    /// @brief Receives the coded frame from the inner framing and decodes it into the receive buffer.
+    void Decode(const Timeout& timeout) {
+        LzDecoder decoder(rxBuffer, rxCapacity);
+        uint8_t chunk[32];
+        while (size_t count = inner.Read(chunk, sizeof(chunk), timeout)) {
+            decoder.Feed(chunk, count);
+            if (inner.EndOfFrame()) {
+                break;
+            }
+        }
+        if (inner.FramePosition() == 0 && !inner.EndOfFrame()) {
+            return; // Nothing arrived, try again on the next read
+        }
+        decoded = true;
+        rxLength = decoder.Complete() ? decoder.Length() : 0;
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// @brief Updates a CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) with one byte.
+/// Uses a 16 entry nibble table, a trade-off between code size and speed for small targets.
+/// Appending the final CRC big-endian to the data makes the CRC over data and CRC 0.
+/// @param crc The CRC so far, start with `Crc16Initial`.
+/// @param byte The next data byte.
+/// @return The updated CRC.
+inline uint16_t Crc16Update(uint16_t crc, uint8_t byte) {
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    crc = static_cast<uint16_t>((crc << 4) ^ table[(crc >> 12) ^ (byte >> 4)]);
+    crc = static_cast<uint16_t>((crc << 4) ^ table[(crc >> 12) ^ (byte & 0x0F)]);
+    return crc;
+}
+
+/// @brief The initial value of a CRC-16/CCITT-FALSE.
+constexpr uint16_t Crc16Initial = 0xFFFF;
+
+/// @brief Computes the CRC-16/CCITT-FALSE of a block of bytes.
+inline uint16_t Crc16(const uint8_t* data, size_t size, uint16_t crc = Crc16Initial) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = Crc16Update(crc, data[i]);
+    }
+    return crc;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstring>
+#include "IStream.h"
+
+/// @brief An `IStream` that reads one complete frame from memory and forwards writes to another stream.
+/// The non-blocking `CommandExecutor` collects incoming bytes until a frame is complete, then
+/// hands the frame to the framing through this stream. Reads therefore never wait: once the
+/// frame is used up they return 0 at once, whatever the timeout.
+/// `Peek` exposes the remaining bytes directly, so framings scan the frame without copying it.
+class FrameStream : public IStream {
+    const uint8_t* frame;  ///< The received frame, including its delimiter.
+    size_t frameSize;      ///< Size of `frame` in bytes.
+    size_t position = 0;   ///< Read position within `frame`.
+    IStream& output;       ///< Stream that receives everything written.
+
+public:
+    /// @brief Constructs a `FrameStream` over a received frame.
+    /// @param data The frame bytes, which must stay valid while the stream is used.
+    /// @param size The number of bytes in the frame.
+    /// @param out The stream writes and flushes are forwarded to.
+    FrameStream(const uint8_t* data, size_t size, IStream& out)
+        : frame(data), frameSize(size), output(out) {}
+
+    /// @brief Starts reading another frame, so one stream can serve a sequence of frames.
+    /// @param data The frame bytes, which must stay valid while the stream is used.
+    /// @param size The number of bytes in the frame.
+    void Reset(const uint8_t* data, size_t size) {
+        frame = data;
+        frameSize = size;
+        position = 0;
+    }
+
+    /// @brief Copies up to `size` unread frame bytes into `data`.
+    /// @return The number of bytes read, 0 once the whole frame has been read.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        size_t count = size < frameSize - position ? size : frameSize - position;
+        memcpy(data, frame + position, count);
+        position += count;
+        return count;
+    }
+
+    /// @brief Exposes the unread part of the frame.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        data = frame + position;
+        return frameSize - position;
+    }
+
+    /// @brief Consumes bytes previously exposed by `Peek`.
+    virtual void Consume(size_t size) override {
+        position += size;
+    }
+
+    /// @brief Forwards data to the output stream.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        return output.Write(data, size, timeout);
+    }
+
+    /// @brief Flushes the output stream.
+    virtual void Flush(const Timeout& timeout) override {
+        output.Flush(timeout);
+    }
+};
@@ -17,4 +17,12 @@ public:
     /// @brief Constructs a Framing object over an existing Stream.
     /// @param stream The base stream to which framing operations will be applied.
     Framing(IStream& stream) : baseStream(stream) {}
+
+    /// @brief Returns true once the whole current frame has been read; further reads return 0.
+    /// The executor uses this to tell whether a frame holds more batched requests.
+    virtual bool EndOfFrame() const = 0;
+
+    /// @brief Returns the number of payload bytes of the current frame consumed so far.
+    /// Zero means no frame data has been received yet, or the frame is empty.
+    virtual size_t FramePosition() const = 0;
 };
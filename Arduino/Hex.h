@@ -0,0 +1,8 @@
+#pragma once
+#include <cstdint>
+
+/// @brief An unsigned value that text formats write in hexadecimal, e.g. "0x1f".
+/// Wrap register values, addresses or masks in it; binary formats send it like a `uint64_t`.
+struct Hex {
+    uint64_t value; ///< The wrapped value.
+};
@@ -32,4 +32,17 @@ public:
     /// Implementations may choose to make this function a no-op if buffering is not applicable.
     /// @param timeout A Timeout object specifying the maximum time to wait for flushing to complete.
     virtual void Flush(const Timeout& timeout) = 0;
+
+    /// @brief Exposes data the stream has already buffered, without consuming it.
+    /// Buffered streams wait up to `timeout` for at least one byte and return a pointer into their
+    /// read buffer, so callers can scan a whole chunk instead of reading byte by byte.
+    /// Unbuffered streams keep this default, which returns 0; callers then fall back to `Read`.
+    /// @param data Set to the first available byte when the return value is non-zero.
+    /// @param timeout A Timeout object specifying the maximum time to wait for data.
+    /// @return The number of contiguous bytes available at `data`.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) { return 0; }
+
+    /// @brief Consumes bytes previously exposed by `Peek`.
+    /// @param size The number of bytes to consume, at most the amount returned by `Peek`.
+    virtual void Consume(size_t size) {}
 };
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "ObjectStream.h"
+#include "CommandStructures.h"
+
+/// @brief The reason a job function is called.
+enum class JobPhase : uint8_t {
+    Start,   ///< Called while the request is executed: read the arguments and set up the job state.
+    Run,     ///< Called on every `Tick` while the job is pending: make some progress and return quickly.
+    Report,  ///< Called once after the job has finished: write its outputs.
+    Chunk,   ///< Streams only, called when a chunk may be sent: write the chunk's outputs.
+};
+
+/// @brief Bytes of per-job state storage available through `JobContext::State`.
+constexpr size_t JobStateSize = 16;
+
+struct JobContext;
+
+/// @brief Type alias for an asynchronous command, a polled state machine.
+/// The function is called with `job.phase` set to the current phase. In the `Start` phase it reads
+/// its arguments from `objStream` and returns `Pending` to continue as a job, or `Streaming` to
+/// continue as a stream (see below); any other result finishes the command right away, like a plain `CommandFunc`, and its outputs are sent at once.
+/// In the `Run` phase `objStream` is not connected; the function returns `Pending` until the job
+/// is done and then its final result. In the `Report` phase it writes its outputs to `objStream`;
+/// the return value is ignored.
+///
+/// A job that returns `Streaming` from the `Start` phase is a stream: it sends a sequence of chunks,
+/// each in a frame of its own, and only as many as the client has granted credits for (see
+/// `BuiltinStreamCredit`). In the `Run` phase a stream returns `Streaming` when a chunk is ready,
+/// `Pending` when it is not, or its final result to end the stream. For a ready chunk the executor
+/// spends a credit and calls the function in the `Chunk` phase to write it; without credit nothing
+/// is sent and the chunk should be kept until a later `Run`. The return value of `Chunk` is ignored.
+/// The final result is sent after the `Report` phase, like a job's. Streams always push their chunks
+/// and final result, whatever the table's `JobCompletion` mode.
+/// @param job The job's slot, holding the phase and the job's own state.
+/// @param objStream The stream for arguments (`Start`) or outputs (`Report`, `Chunk`).
+/// @return `Pending` while the job is running, `Streaming` as described for streams, otherwise the final result.
+using JobFunc = CommandResultCodes (*)(JobContext& job, ObjectStream& objStream);
+
+/// @brief One slot of a `JobTable`, holding a running or finished job.
+struct JobContext {
+    JobFunc func;                 ///< The job function, called on every phase.
+    uint32_t handle;              ///< Handle returned to the client; 0 marks a free slot.
+    uint32_t requestId;           ///< Id of the request that started the job, used for its completion.
+    CommandResultCodes result;    ///< `Pending` while the job runs, `Streaming` while a stream is open, then the final result.
+    JobPhase phase;               ///< The phase the job function is being called for.
+    uint16_t credits;             ///< Chunks a stream may still send; a stream may set an initial count in `Start`.
+    uint32_t step;                ///< Free for the job's state machine, 0 when the job starts.
+    alignas(8) uint8_t state[JobStateSize]; ///< Free for the job's state, zeroed when the job starts.
+
+    /// @brief Allows a stream to send `count` more chunks, saturating at `UINT16_MAX`.
+    void AddCredits(uint32_t count) {
+        credits = count < static_cast<uint32_t>(UINT16_MAX - credits) ? static_cast<uint16_t>(credits + count) : UINT16_MAX;
+    }
+
+    /// @brief Returns the job state storage as a `T`.
+    /// @tparam T A trivially copyable type no larger than `JobStateSize`.
+    template <typename T>
+    T& State() {
+        static_assert(sizeof(T) <= JobStateSize, "Job state does not fit JobStateSize");
+        return *reinterpret_cast<T*>(state);
+    }
+};
+
+/// @brief How the result of a finished job reaches the client.
+enum class JobCompletion : uint8_t {
+    Push,  ///< A completion frame is sent as soon as the job finishes, and its slot is freed.
+    Poll,  ///< The job waits in its slot until the client asks with `BuiltinJobStatus`.
+};
+
+/// @brief A bounded table of jobs over caller-provided slots.
+/// Nothing is allocated: the number of jobs that can run at once is the number of slots, and
+/// a job request that finds no free slot is answered with `Busy`. See `StaticJobTable`.
+class JobTable {
+    JobContext* jobs;          ///< The job slots.
+    size_t capacity;           ///< Number of slots in `jobs`.
+    JobCompletion completion;  ///< How finished jobs are reported.
+    uint32_t lastHandle = 0;   ///< The most recently issued handle.
+
+public:
+    /// @brief Constructs a job table over existing slots.
+    /// @param slots The job slots; they must start out zeroed, i.e. free.
+    /// @param size The number of slots.
+    /// @param mode How finished jobs are reported to the client.
+    JobTable(JobContext* slots, size_t size, JobCompletion mode)
+        : jobs(slots), capacity(size), completion(mode) {}
+
+    /// @brief Claims a free slot for a new job and gives it a fresh handle.
+    /// @param func The job function.
+    /// @param requestId The id of the request starting the job.
+    /// @return The slot in the `Start` phase, or nullptr if every slot is in use.
+    JobContext* Allocate(JobFunc func, uint32_t requestId) {
+        for (JobContext& job : *this) {
+            if (job.handle == 0) {
+                memset(&job, 0, sizeof(job));
+                job.func = func;
+                job.requestId = requestId;
+                job.result = Pending;
+                job.phase = JobPhase::Start;
+                // Handles are not reused soon, so a stale handle does not find a newer job
+                job.handle = ++lastHandle ? lastHandle : ++lastHandle;
+                return &job;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Finds the job with a handle.
+    /// @return The job's slot, or nullptr if no job has this handle.
+    JobContext* Find(uint32_t handle) {
+        if (handle == 0) {
+            return nullptr;
+        }
+        for (JobContext& job : *this) {
+            if (job.handle == handle) {
+                return &job;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Frees the slot of a job.
+    void Release(JobContext& job) {
+        job.handle = 0;
+    }
+
+    /// @brief Returns how finished jobs are reported to the client.
+    JobCompletion Completion() const { return completion; }
+
+    JobContext* begin() { return jobs; }
+    JobContext* end() { return jobs + capacity; }
+};
+
+/// @brief A `JobTable` with its slots stored inline.
+/// @tparam N The maximum number of jobs running at once.
+template <size_t N>
+class StaticJobTable : public JobTable {
+    JobContext slots[N] = {};
+
+public:
+    /// @brief Constructs an empty job table.
+    /// @param mode How finished jobs are reported to the client.
+    explicit StaticJobTable(JobCompletion mode = JobCompletion::Push)
+        : JobTable(slots, N, mode) {}
+};
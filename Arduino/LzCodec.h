@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/// @file LzCodec.h
+/// @brief A small LZ77 codec for protocol frames, with a dictionary of protocol tokens.
+/// Every coded byte below 0x80 is a literal from the input, so ASCII stays readable and a payload
+/// without '\n' codes without '\n'. The coded form travels over `NewLineFraming` as well as
+/// `CobsFraming`:
+///
+///     0x00-0x7F  a literal byte
+///     0x80-0xBF  a back-reference of length (b & 0x3F) + 3, followed by 0x80 | (distance - 1),
+///                copying from up to 128 bytes back in the decoded frame
+///     0xC0-0xFE  the dictionary word (b - 0xC0), see `LzDictionary`
+///     0xFF       a run of n bytes of 0x80 and above, followed by 0x80 | n and the n bytes
+///
+/// Plain ASCII is a valid coding of itself, so a frame never grows unless it holds binary data.
+/// Encoding needs no memory besides its input; decoding only its output, which doubles as the
+/// back-reference window.
+
+/// @brief Number of words in `LzDictionary`.
+constexpr size_t LzDictionarySize = 40;
+
+/// @brief Words preloaded into every frame's dictionary: the ASCII result names and the numbers
+/// and built-in command codes that occur most often in requests and responses. Changing the list
+/// changes the coding, so both ends must use the same version.
+inline const char* const* LzDictionary() {
+    static const char* const words[LzDictionarySize] = {
+        "Ok ", "GeneralError ", "SerializeError ", "CommandNotFound ", "Pending ", "Busy ",
+        "JobNotFound ", "Streaming ", "0 ", "1 ", "2 ", "3 ", "4 ", "5 ", "6 ", "7 ", "8 ", "9 ",
+        "10 ", "16 ", "32 ", "64 ", "100 ", "128 ", "255 ", "256 ", "512 ", "1000 ", "1023 ",
+        "1024 ", "4095 ", "65535 ", "-1 ", "-256 ", "-255 ", "-254 ", "-253 ", "0.0 ", "1.0 ", "0.5 ",
+    };
+    return words;
+}
+
+/// @brief Returns the longest dictionary word at the start of `data`, or -1 if none matches.
+inline int LzFindWord(const uint8_t* data, size_t size, size_t& length) {
+    const char* const* words = LzDictionary();
+    int best = -1;
+    length = 0;
+    for (size_t i = 0; i < LzDictionarySize; ++i) {
+        const char* word = words[i];
+        if (static_cast<uint8_t>(word[0]) != data[0]) {
+            continue;
+        }
+        size_t wordLength = strlen(word);
+        if (wordLength > length && wordLength <= size && memcmp(word, data, wordLength) == 0) {
+            best = static_cast<int>(i);
+            length = wordLength;
+        }
+    }
+    return best;
+}
+
+/// @brief Encodes a frame payload, passing the coded bytes to `emit` a token at a time.
+/// @param in The payload.
+/// @param size Its length.
+/// @param emit Called as `emit(const uint8_t* data, size_t size)` with each coded token.
+/// @return The coded length. ASCII never codes longer than itself; binary data may double.
+template <typename Emit>
+size_t LzEncode(const uint8_t* in, size_t size, Emit&& emit) {
+    size_t pos = 0;
+    size_t written = 0;
+    uint8_t token[2];
+    while (pos < size) {
+        uint8_t byte = in[pos];
+        if (byte >= 0x80) {
+            // Collect the run of high bytes
+            size_t run = 1;
+            while (run < 0x7F && pos + run < size && in[pos + run] >= 0x80) {
+                run++;
+            }
+            token[0] = 0xFF;
+            token[1] = static_cast<uint8_t>(0x80 | run);
+            emit(token, 2);
+            emit(in + pos, run);
+            written += run + 2;
+            pos += run;
+            continue;
+        }
+
+        // Longest match in the last 128 bytes of this frame
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+        size_t maxLength = size - pos < 66 ? size - pos : 66;
+        size_t windowStart = pos > 128 ? pos - 128 : 0;
+        for (size_t from = windowStart; from < pos && maxLength >= 3; ++from) {
+            if (in[from] != byte) {
+                continue;
+            }
+            size_t length = 1;
+            while (length < maxLength && in[from + length] == in[pos + length]) {
+                length++;
+            }
+            if (length >= bestLength) {
+                bestLength = length; // Prefer the nearest of equal matches
+                bestDistance = pos - from;
+            }
+        }
+
+        size_t wordLength;
+        int word = LzFindWord(in + pos, size - pos, wordLength);
+
+        size_t count = 1;
+        if (word >= 0 && wordLength >= 2 && wordLength + 1 >= bestLength) {
+            token[0] = static_cast<uint8_t>(0xC0 + word);
+            pos += wordLength;
+        } else if (bestLength >= 3) {
+            token[0] = static_cast<uint8_t>(0x80 | (bestLength - 3));
+            token[1] = static_cast<uint8_t>(0x80 | (bestDistance - 1));
+            count = 2;
+            pos += bestLength;
+        } else {
+            token[0] = byte;
+            pos++;
+        }
+        emit(token, count);
+        written += count;
+    }
+    return written;
+}
+
+/// @brief A decoder that takes the coded payload in pieces, as it arrives.
+class LzDecoder {
+    uint8_t* out;           ///< The decoded frame, also the back-reference window.
+    size_t capacity;        ///< Size of `out`.
+    size_t length = 0;      ///< Decoded bytes so far.
+    uint8_t state = 0;      ///< 0 between tokens, or the first byte of an unfinished token.
+    uint8_t runLeft = 0;    ///< Bytes left in a run of high bytes.
+    bool failed = false;
+
+public:
+    /// @brief Constructs a decoder writing into `buffer`.
+    LzDecoder(uint8_t* buffer, size_t size) : out(buffer), capacity(size) {}
+
+    /// @brief Decodes the next piece of the coded payload.
+    /// @return False once the coding is invalid or the output does not fit.
+    bool Feed(const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size && !failed; ++i) {
+            uint8_t byte = data[i];
+            if (runLeft) {
+                Put(byte);
+                runLeft--;
+            } else if (state == 0xFF) {
+                runLeft = byte & 0x7F;
+                state = 0;
+                failed = runLeft == 0;
+            } else if (state) {
+                size_t count = (state & 0x3F) + 3;
+                size_t distance = (byte & 0x7F) + 1;
+                state = 0;
+                if (distance > length || length + count > capacity) {
+                    failed = true;
+                    break;
+                }
+                for (size_t j = 0; j < count; ++j) {
+                    out[length] = out[length - distance]; // May overlap, byte by byte
+                    length++;
+                }
+            } else if (byte < 0x80) {
+                Put(byte);
+            } else if (byte < 0xC0 || byte == 0xFF) {
+                state = byte;
+            } else if (static_cast<size_t>(byte - 0xC0) < LzDictionarySize) {
+                const char* word = LzDictionary()[byte - 0xC0];
+                size_t wordLength = strlen(word);
+                if (length + wordLength > capacity) {
+                    failed = true;
+                    break;
+                }
+                memcpy(out + length, word, wordLength);
+                length += wordLength;
+            } else {
+                failed = true;
+            }
+        }
+        return !failed;
+    }
+
+    /// @brief Returns true if the coded payload ended on a token boundary and decoded without error.
+    bool Complete() const { return !failed && state == 0 && runLeft == 0; }
+
+    /// @brief Returns the number of decoded bytes.
+    size_t Length() const { return length; }
+
+private:
+    void Put(uint8_t byte) {
+        if (length >= capacity) {
+            failed = true;
+            return;
+        }
+        out[length++] = byte;
+    }
+};
@@ -1,18 +1,24 @@
 #pragma once
+#include <cstring>
 #include "Framing.h"
+#include "Scan.h"
 
 /// @brief A `Framing` implementation that uses newline characters (`\n`) to frame messages.
 /// The `NewLineFraming` class reads and writes data, treating each line ending with `\n`
 /// as a separate message, and includes timeout support for these operations.
 class NewLineFraming : public Framing {
     bool anyWritten = false;
+    bool frameEnded = false; ///< Set once the newline ending the current frame has been read.
+    size_t position = 0;     ///< Number of frame bytes consumed, excluding the newline.
 public:
     /// @brief Constructs a `NewLineFraming` object using an existing `Stream`.
     /// @param stream The base stream to which newline framing operations will be applied.
     NewLineFraming(IStream& stream) : Framing(stream) {}
 
     /// @brief Reads data from the base stream until a newline character (`\n`) is encountered or the timeout expires.
-    /// The newline character is discarded and not included in the output buffer.
+    /// The newline character is discarded and not included in the output buffer. Once the newline has been
+    /// read, the frame is complete and further reads return 0.
+    /// If the base stream is buffered, whole chunks are scanned for the newline at once.
     /// @param data A pointer to the buffer where the read data will be stored.
     /// @param size The maximum number of bytes to read (excluding the newline character).
     /// @param timeout A `Timeout` object specifying the maximum time allowed for reading.
@@ -20,20 +26,79 @@ public:
     virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
         uint8_t* byteData = static_cast<uint8_t*>(data);
         size_t bytesRead = 0;
+        TimeoutCheck<> deadline(timeout); // Checked once per byte on unbuffered streams
 
         // Read bytes until we encounter a newline or reach the buffer limit
-        while (!timeout.Expired() && bytesRead < size) {
-            if (baseStream.Read(byteData + bytesRead, 1, timeout)) {
+        while (!frameEnded && bytesRead < size) {
+            const uint8_t* window;
+            size_t available = baseStream.Peek(window, timeout);
+            if (available) {
+                // Buffered base stream, copy everything up to the newline in one go
+                size_t count = available < size - bytesRead ? available : size - bytesRead;
+                const uint8_t* newline = FindByte(window, count, '\n');
+                if (newline) {
+                    count = newline - window;
+                    frameEnded = true;
+                }
+                memcpy(byteData + bytesRead, window, count);
+                bytesRead += count;
+                baseStream.Consume(frameEnded ? count + 1 : count);
+                position += count;
+            } else if (deadline.Expired()) {
+                break;
+            } else if (baseStream.Read(byteData + bytesRead, 1, timeout)) {
                 if (byteData[bytesRead] == '\n') {
-                    return bytesRead; // Newline detected, end the frame
+                    frameEnded = true; // Newline detected, end the frame
+                } else {
+                    bytesRead++;
+                    position++;
                 }
-                bytesRead++;
             }
         }
 
         return bytesRead; // Return the number of bytes read if no newline was found
     }
 
+    /// @brief Exposes the buffered part of the current frame, up to but excluding the newline.
+    /// When the next byte is the newline it is consumed, the frame ends and 0 is returned.
+    /// @param data Set to the first available byte of the frame.
+    /// @param timeout A `Timeout` object specifying the maximum time to wait for data.
+    /// @return The number of frame bytes available at `data`, 0 if the base stream is not buffered.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        if (frameEnded) {
+            return 0;
+        }
+
+        size_t available = baseStream.Peek(data, timeout);
+        if (!available) {
+            return 0;
+        }
+
+        const uint8_t* newline = FindByte(data, available, '\n');
+        if (newline == data) {
+            baseStream.Consume(1);
+            frameEnded = true;
+            return 0;
+        }
+        return newline ? newline - data : available;
+    }
+
+    /// @brief Consumes frame bytes previously exposed by `Peek`.
+    virtual void Consume(size_t size) override {
+        baseStream.Consume(size);
+        position += size;
+    }
+
+    /// @brief Returns true once the newline ending the frame has been read.
+    virtual bool EndOfFrame() const override {
+        return frameEnded;
+    }
+
+    /// @brief Returns the number of frame bytes consumed so far, excluding the newline.
+    virtual size_t FramePosition() const override {
+        return position;
+    }
+
     /// @brief Writes data to the base stream and appends a newline character (`\n`) to signify the end of the frame.
     /// This function attempts to write the provided data, followed by a newline, within the specified timeout.
     /// @param data A pointer to the buffer containing the data to write.
@@ -58,7 +123,7 @@ public:
     virtual void Flush(const Timeout& timeout) override {
         if(anyWritten)
         {
-            baseStream.Write("\n", 2, timeout);
+            baseStream.Write("\n", 1, timeout);
         }
         baseStream.Flush(timeout); // Delegate flush to the base stream
     }
@@ -0,0 +1,19 @@
+#pragma once
+#include "IStream.h"
+
+/// @brief An `IStream` with nothing to read that discards everything written.
+/// Used where an `ObjectStream` is required but no I/O may take place.
+class NullStream : public IStream {
+public:
+    /// @brief There is never anything to read, returns 0 at once.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        return 0;
+    }
+
+    /// @brief Discards the data and reports it as written.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        return size;
+    }
+
+    virtual void Flush(const Timeout& timeout) override {}
+};
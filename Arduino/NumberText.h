@@ -0,0 +1,407 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+/// @file NumberText.h
+/// @brief Fast conversions between numbers and their ASCII text, used by the ASCII serializers.
+/// Formatting writes two digits per division from a lookup table. Parsing accepts exactly one
+/// number per call and reports malformed text and values out of range of the target type,
+/// instead of silently wrapping like `atoi`. On 64-bit little-endian hosts eight digits are
+/// checked and converted per step with SWAR (SIMD within a register) arithmetic.
+
+#if UINTPTR_MAX == UINT64_MAX && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NUMBERTEXT_SWAR 1
+#else
+#define NUMBERTEXT_SWAR 0
+#endif
+
+/// @brief Longest text produced by the formatters: a 20 digit value with sign, or a float.
+constexpr size_t NumberTextMaxLength = 24;
+
+/// @brief Returns the two ASCII digits of `value` (0..99).
+inline const char* DigitPair(uint32_t value) {
+    static const char pairs[201] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    return pairs + value * 2;
+}
+
+/// @brief Writes the decimal digits of `value` so that they end right before `end`.
+/// @return A pointer to the first digit.
+inline char* FormatUnsigned(uint64_t value, char* end) {
+    // Peel off eight digits at a time until the rest fits 32-bit arithmetic, which is cheaper on small targets
+    while (value > UINT32_MAX) {
+        uint64_t high = value / 100000000;
+        uint32_t low = static_cast<uint32_t>(value - high * 100000000);
+        for (int i = 0; i < 4; ++i) {
+            uint32_t next = low / 100;
+            memcpy(end -= 2, DigitPair(low - next * 100), 2);
+            low = next;
+        }
+        value = high;
+    }
+
+    uint32_t rest = static_cast<uint32_t>(value);
+    while (rest >= 100) {
+        uint32_t next = rest / 100;
+        memcpy(end -= 2, DigitPair(rest - next * 100), 2);
+        rest = next;
+    }
+    if (rest >= 10) {
+        memcpy(end -= 2, DigitPair(rest), 2);
+    } else {
+        *--end = static_cast<char>('0' + rest);
+    }
+    return end;
+}
+
+/// @brief Writes `value` in decimal, with a leading '-' if negative, ending right before `end`.
+/// @return A pointer to the first character.
+inline char* FormatSigned(int64_t value, char* end) {
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    char* begin = FormatUnsigned(magnitude, end);
+    if (value < 0) {
+        *--begin = '-';
+    }
+    return begin;
+}
+
+/// @brief Writes `value` as "0x" followed by lowercase hex digits, ending right before `end`.
+/// @return A pointer to the first character.
+inline char* FormatHex(uint64_t value, char* end) {
+    static const char digits[] = "0123456789abcdef";
+    do {
+        *--end = digits[value & 0xF];
+        value >>= 4;
+    } while (value);
+    *--end = 'x';
+    *--end = '0';
+    return end;
+}
+
+#if NUMBERTEXT_SWAR
+/// @brief Returns true if all eight bytes of `chunk` are ASCII digits.
+inline bool IsEightDigits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+            (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+/// @brief Converts eight ASCII digits, first digit in the lowest byte, to their value.
+/// Adjacent digits are combined into pairs, quads and finally the full number with three multiplications.
+inline uint32_t ParseEightDigits(uint64_t chunk) {
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+    return static_cast<uint32_t>(((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+}
+#endif
+
+/// @brief Parses a run of decimal digits with no sign.
+/// @param text The digits, not necessarily null-terminated.
+/// @param length The number of characters in `text`.
+/// @param value Receives the value.
+/// @return False if `text` is empty, holds anything but digits, or exceeds 64 bits.
+inline bool ParseDigits(const char* text, size_t length, uint64_t& value) {
+    if (length == 0 || length > 20) {
+        return false;
+    }
+
+    uint64_t result = 0;
+    size_t i = 0;
+#if NUMBERTEXT_SWAR
+    // Up to 19 digits cannot overflow, so whole chunks need no range checks
+    for (; i + 8 <= length && i + 8 <= 19; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, text + i, 8);
+        if (!IsEightDigits(chunk)) {
+            return false;
+        }
+        result = result * 100000000 + ParseEightDigits(chunk);
+    }
+#endif
+    for (; i < length; ++i) {
+        uint32_t digit = static_cast<uint8_t>(text[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        if (i == 19 && result > (UINT64_MAX - digit) / 10) {
+            return false; // Only a 20th digit can overflow
+        }
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
+/// @brief Parses a decimal integer with an optional sign into `T`.
+/// @tparam T An integer type of at most 64 bits.
+/// @return False if the text is not a number or the value does not fit `T`. `value` is then unchanged.
+template <typename T>
+bool ParseInteger(const char* text, size_t length, T& value) {
+    bool negative = false;
+    if (length > 0 && (text[0] == '-' || text[0] == '+')) {
+        negative = text[0] == '-';
+        text++;
+        length--;
+    }
+
+    uint64_t magnitude;
+    if (!ParseDigits(text, length, magnitude)) {
+        return false;
+    }
+
+    constexpr uint64_t max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+    if (std::is_signed<T>::value) {
+        if (magnitude > max + negative) {
+            return false;
+        }
+        value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+    } else {
+        if (magnitude > max || (negative && magnitude != 0)) {
+            return false;
+        }
+        value = static_cast<T>(magnitude);
+    }
+    return true;
+}
+
+/// @brief Parses up to 16 hex digits, with or without a "0x" prefix.
+/// @return False if the text is not a hex number or exceeds 64 bits.
+inline bool ParseHex(const char* text, size_t length, uint64_t& value) {
+    if (length > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text += 2;
+        length -= 2;
+    }
+    if (length == 0 || length > 16) {
+        return false;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t ch = static_cast<uint8_t>(text[i]);
+        uint8_t digit = ch - '0';
+        if (digit > 9) {
+            digit = (ch | 0x20) - 'a' + 10; // Folds upper to lower case
+            if (digit < 10 || digit > 15) {
+                return false;
+            }
+        }
+        result = (result << 4) | digit;
+    }
+    value = result;
+    return true;
+}
+
+/// @brief Returns 10 to the power `n`, for `n` >= 0.
+/// Powers up to 10^22 are exact doubles and come from a table.
+inline double Pow10(int n) {
+    static const double powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    double result = 1;
+    while (n > 22) {
+        result *= 1e22;
+        n -= 22;
+    }
+    return result * powers[n];
+}
+
+/// @brief Returns `value` times 10 to the power `n`, dividing for negative `n`.
+inline double Scale10(double value, int n) {
+    return n >= 0 ? value * Pow10(n) : value / Pow10(-n);
+}
+
+/// @brief Formats a float with the fewest significant digits, at most 9, that read back as the same float.
+/// Values from 1e-5 up to 1e9 are written in fixed notation, others as "d.ddde[-]x".
+/// Targets where `double` is 32 bits (AVR) may be off in the last digit.
+/// @param value The value to format.
+/// @param buffer Receives the text; needs `NumberTextMaxLength` bytes. It is not null-terminated.
+/// @return The number of characters written.
+inline size_t FormatFloat(float value, char* buffer) {
+    char* out = buffer;
+    if (value != value) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (value < 0) {
+        *out++ = '-';
+        value = -value;
+    }
+    if (value > std::numeric_limits<float>::max()) {
+        memcpy(out, "inf", 3);
+        return out + 3 - buffer;
+    }
+    if (value == 0) {
+        *out++ = '0';
+        return out - buffer;
+    }
+
+    // Decimal exponent from the binary one (log10(2) ~ 77/256), corrected by one step if needed
+    double v = value;
+    int exponent2;
+    frexp(v, &exponent2);
+    int exponent = ((exponent2 - 1) * 77) >> 8;
+    if (v >= Scale10(1, exponent + 1)) {
+        exponent++;
+    } else if (v < Scale10(1, exponent)) {
+        exponent--;
+    }
+
+    // Nine significant digits always read back as the same float
+    uint32_t mantissa = static_cast<uint32_t>(Scale10(v, 8 - exponent) + 0.5);
+    if (mantissa >= 1000000000) {
+        mantissa = (mantissa + 5) / 10;
+        exponent++;
+    }
+    int digits = 9;
+
+    // Prefer the fewest digits that do too, so 0.1f is written as 0.1 and not 0.100000001
+    static const uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    for (int shorter = 1; shorter < 9; ++shorter) {
+        uint32_t divisor = powers[9 - shorter];
+        uint32_t candidate = (mantissa + divisor / 2) / divisor;
+        int candidateExponent = exponent;
+        if (candidate == powers[shorter]) {
+            candidate /= 10; // Rounded up to the next power of ten, e.g. 9.99 to 10.0
+            candidateExponent++;
+        }
+        if (static_cast<float>(Scale10(candidate, candidateExponent - shorter + 1)) == value) {
+            mantissa = candidate;
+            exponent = candidateExponent;
+            digits = shorter;
+            break;
+        }
+    }
+    while (mantissa % 10 == 0) {
+        mantissa /= 10;
+        digits--;
+    }
+
+    char text[10];
+    FormatUnsigned(mantissa, text + digits);
+
+    if (exponent >= -5 && exponent < 9) {
+        if (exponent < 0) {
+            // 0.000ddd
+            *out++ = '0';
+            *out++ = '.';
+            for (int i = -1; i > exponent; --i) {
+                *out++ = '0';
+            }
+            memcpy(out, text, digits);
+            out += digits;
+        } else if (digits <= exponent + 1) {
+            // ddd000
+            memcpy(out, text, digits);
+            out += digits;
+            for (int i = digits; i <= exponent; ++i) {
+                *out++ = '0';
+            }
+        } else {
+            // ddd.ddd
+            memcpy(out, text, exponent + 1);
+            out += exponent + 1;
+            *out++ = '.';
+            memcpy(out, text + exponent + 1, digits - exponent - 1);
+            out += digits - exponent - 1;
+        }
+        return out - buffer;
+    }
+
+    // d.ddde[-]xx
+    *out++ = text[0];
+    if (digits > 1) {
+        *out++ = '.';
+        memcpy(out, text + 1, digits - 1);
+        out += digits - 1;
+    }
+    *out++ = 'e';
+    char exponentText[4];
+    char* exponentBegin = FormatSigned(exponent, exponentText + sizeof(exponentText));
+    size_t exponentLength = exponentText + sizeof(exponentText) - exponentBegin;
+    memcpy(out, exponentBegin, exponentLength);
+    return out + exponentLength - buffer;
+}
+
+/// @brief Parses a decimal float: optional sign, digits with an optional '.', optional exponent; or "nan"/"inf".
+/// Numbers with at most 15 significant digits and a decimal exponent within +-22 are converted
+/// exactly with a single multiplication or division; anything else is handed to `strtod`.
+/// @param text The text; the character after it must be readable (a terminator), for `strtod`.
+/// @param length The number of characters in `text`.
+/// @param value Receives the value.
+/// @return False if the text is not a number or its magnitude is too large for a float.
+inline bool ParseFloat(const char* text, size_t length, float& value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    if (length - i == 3 && (memcmp(text + i, "nan", 3) == 0 || memcmp(text + i, "inf", 3) == 0)) {
+        value = text[i] == 'n' ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+        value = negative ? -value : value;
+        return true;
+    }
+
+    uint64_t mantissa = 0;
+    int significant = 0;   // Digits accumulated into mantissa
+    int exponent = 0;      // Decimal exponent applied to mantissa
+    bool anyDigits = false;
+    bool fraction = false;
+    for (; i < length; ++i) {
+        uint32_t digit = static_cast<uint8_t>(text[i] - '0');
+        if (digit <= 9) {
+            anyDigits = true;
+            if (significant < 19) {
+                if (mantissa || digit) {
+                    significant++; // Leading zeros are not significant
+                }
+                mantissa = mantissa * 10 + digit;
+                exponent -= fraction;
+            } else {
+                exponent += !fraction; // Digits beyond 19 only scale the value
+            }
+        } else if (text[i] == '.' && !fraction) {
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (!anyDigits) {
+        return false;
+    }
+
+    if (i < length && (text[i] == 'e' || text[i] == 'E')) {
+        int32_t written;
+        if (!ParseInteger(text + i + 1, length - i - 1, written) || written > 9999 || written < -9999) {
+            return false;
+        }
+        exponent += written;
+        i = length;
+    }
+    if (i != length) {
+        return false;
+    }
+
+    double result;
+    if (significant <= 15 && exponent >= -22 && exponent <= 22) {
+        result = Scale10(static_cast<double>(mantissa), exponent); // Exact operands, one rounding
+    } else {
+        result = strtod(text + (text[0] == '-' || text[0] == '+'), nullptr);
+    }
+    float rounded = static_cast<float>(result); // Values just above the float range round down to it
+    if (std::isinf(rounded)) {
+        return false;
+    }
+    value = negative ? -rounded : rounded;
+    return true;
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstring>
+#include "Arena.h"
 #include "Serializer.h"
 
 
@@ -10,6 +12,8 @@
 class ObjectStream {
     IStream& baseStream;    ///< Reference to the underlying `Stream` used for communication.
     Serializer& serializer; ///< Reference to the `Serializer` for object serialization and deserialization.
+    const Timeout* deadline = nullptr; ///< Deadline of the request being executed, null if it has none.
+    Arena* arena = nullptr;            ///< Receives variable-length arguments, null if there is none.
 
 public:
     /// @brief Constructs an `ObjectStream` with the specified `Stream` and `Serializer`.
@@ -17,6 +21,27 @@ public:
     /// @param ser The serializer used for serializing and deserializing objects to and from the stream.
     ObjectStream(IStream& stream, Serializer& ser) : baseStream(stream), serializer(ser) {}
 
+    /// @brief Returns the deadline of the request being executed.
+    /// Commands can pass it to their reads and writes, or use its remaining time to budget their
+    /// work, for example how many samples to average. See `CommandExecutorCore::SetRequestBudget`.
+    /// @return The deadline, or `Timeout::Never()` outside of a request.
+    const Timeout& Deadline() const {
+        return deadline ? *deadline : Timeout::Never();
+    }
+
+    /// @brief Sets the deadline returned by `Deadline`, as the executor does around each command.
+    /// @param requestDeadline The deadline, which must outlive its use, or nullptr to clear it.
+    void SetDeadline(const Timeout* requestDeadline) {
+        deadline = requestDeadline;
+    }
+
+    /// @brief Sets the arena `ReadArray`, `ReadBytes` and `ReadString` place their data in, as the
+    /// executor does for each frame, see `CommandExecutorCore::EnableArena`.
+    /// @param requestArena The arena, or nullptr to make those reads fail.
+    void SetArena(Arena* requestArena) {
+        arena = requestArena;
+    }
+
     /// @brief Reads an object of type `T` from the stream.
     /// This method uses the `Serializer` to deserialize an object from the `Stream`
     /// within the specified timeout.
@@ -40,4 +65,100 @@ public:
     bool Write(const T& item, const Timeout& timeout) {
         return serializer.Serialize(baseStream, item, timeout);
     }
+
+    /// @brief Writes an array of `T` in one pass, straight from the caller's memory.
+    /// This is much cheaper than writing the elements one by one: the binary format writes
+    /// them as raw bytes, the ASCII format formats them a chunk at a time.
+    /// @tparam T The element type, one with a `ConstSpan` serializer slot.
+    /// @param data Pointer to the first element.
+    /// @param count The number of elements to write.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the write operation.
+    /// @return True if the array was successfully serialized and written, false otherwise.
+    template<typename T>
+    bool WriteArray(const T* data, size_t count, const Timeout& timeout) {
+        return Write(ConstSpan<T>{data, count}, timeout);
+    }
+
+    /// @brief Reads an array written by `WriteArray` into the caller's storage.
+    /// @tparam T The element type, one with a `SpanBuffer` serializer slot.
+    /// @param data Pointer to the storage for the elements.
+    /// @param capacity The number of elements available at `data`.
+    /// @param count Set to the number of elements received.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read operation.
+    /// @return True if the array was successfully read, false otherwise, also if it has more than `capacity`
+    ///         elements; `count` is then set beyond `capacity`, see `SpanBuffer`.
+    template<typename T>
+    bool ReadArray(T* data, size_t capacity, size_t& count, const Timeout& timeout) {
+        SpanBuffer<T> buffer{data, capacity, 0};
+        bool success = Read(buffer, timeout);
+        count = buffer.size;
+        return success;
+    }
+
+    /// @brief Reads an array written by `WriteArray` into the arena, whatever its length.
+    /// The elements stay valid until the arena is reset, for a command run by the executor until
+    /// the end of the `Tick`; a job that needs them longer copies them into its state.
+    /// @tparam T The element type, one with a `SpanBuffer` serializer slot.
+    /// @param data Set to the first element.
+    /// @param count Set to the number of elements received.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read operation.
+    /// @return True if the array was successfully read, false otherwise, also without an arena or
+    ///         if the array does not fit in what is left of it, which is counted by `Arena::Overflow`.
+    template<typename T>
+    bool ReadArray(const T*& data, size_t& count, const Timeout& timeout) {
+        if (!arena) {
+            return false;
+        }
+        size_t capacity;
+        T* storage = arena->Free<T>(capacity);
+        if (!ReadArray(storage, capacity, count, timeout)) {
+            if (count > capacity) {
+                arena->Overflow();
+            }
+            return false;
+        }
+        arena->Commit(storage, count);
+        data = storage;
+        return true;
+    }
+
+    /// @brief Reads a blob into the arena, see `ReadArray`.
+    bool ReadBytes(ConstByteSpan& bytes, const Timeout& timeout) {
+        return ReadArray(bytes.data, bytes.size, timeout);
+    }
+
+    /// @brief Reads a string into the arena as a null-terminated C string, see `ReadArray`.
+    /// @param text Set to the string.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for the read operation.
+    /// @return True if the string was successfully read, false otherwise.
+    bool ReadString(const char*& text, const Timeout& timeout) {
+        size_t capacity;
+        char* storage = arena ? arena->Free<char>(capacity) : nullptr;
+        if (!storage || capacity == 0) {
+            if (storage) {
+                arena->Overflow();
+            }
+            return false;
+        }
+        TextBuffer buffer{storage, capacity - 1, 0}; // Room for the terminator
+        if (!Read(buffer, timeout)) {
+            if (buffer.size > buffer.capacity) {
+                arena->Overflow();
+            }
+            return false;
+        }
+        storage[buffer.size] = '\0';
+        arena->Commit(storage, buffer.size + 1);
+        text = storage;
+        return true;
+    }
+
+    /// @brief Writes a null-terminated C string, read back with `ReadString`.
+    /// A null `text` is written as an empty string.
+    bool WriteString(const char* text, const Timeout& timeout) {
+        if (!text) {
+            text = "";
+        }
+        return Write(ConstText{text, strlen(text)}, timeout);
+    }
 };
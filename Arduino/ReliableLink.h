@@ -0,0 +1,394 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "CobsFraming.h"
+#include "Framing.h"
+#include "FrameStream.h"
+#include "NullStream.h"
+#include "Scan.h"
+#include "Timeout.h"
+
+/// @brief A reliable, in-order message link over a lossy byte stream, such as an RS-485 bus.
+/// Every message travels as one COBS frame with a CRC-16, so lost and corrupted bytes cost at
+/// most the frame they hit, never its neighbours. Each frame carries a 5 byte header:
+///
+///     flags | seq | ack | sack (16 bits, little-endian)
+///
+/// `seq` numbers data frames modulo 256. `ack` is the next message the receiver has not passed
+/// on yet; every message before it has arrived. Bit i of `sack` reports that message `ack + i`
+/// is held by the receiver, out of order or waiting to be read. Every data frame is answered
+/// with such an acknowledgement.
+///
+/// Up to `Window` messages are in flight. A message is sent again when its retransmit timeout
+/// expires, or at once, a single time, when an acknowledgement shows a later message arrived
+/// while this one did not (selective repeat). The receiver keeps out-of-order messages and
+/// passes them on in order. With `Window` 1 the link degrades to stop-and-wait.
+///
+/// Slots are indexed relative to the oldest message of each direction rather than by
+/// `seq % Window`, which would map two messages in flight to one slot across the wrap of `seq`
+/// whenever `Window` does not divide 256.
+///
+/// The link sits between the byte stream and the `ObjectStream`: `ReliableFraming` presents one
+/// received message as a frame and sends what is written to it as one message. It needs
+/// `2 * Window * MaxPayload` bytes for its message slots plus about `3 * MaxPayload` for frames.
+/// @tparam Window Messages in flight, 1 to 16.
+/// @tparam MaxPayload The largest message in bytes.
+template <size_t Window = 8, size_t MaxPayload = 64>
+class ReliableLink {
+    static_assert(Window >= 1 && Window <= 16, "The acknowledgement bitmap covers 16 messages");
+    static_assert(MaxPayload <= 255, "Message lengths are kept in one byte");
+
+    static constexpr size_t HeaderSize = 5;
+    static constexpr size_t PacketSize = HeaderSize + MaxPayload + 2; ///< Header, payload and CRC.
+    static constexpr size_t EncodedSize = PacketSize + PacketSize / 254 + 2; ///< COBS overhead and delimiter.
+    static constexpr uint8_t FlagData = 0x01;
+
+    /// @brief A sent message kept until it is acknowledged.
+    struct TxSlot {
+        uint8_t data[MaxPayload];
+        uint8_t length;
+        bool acked;          ///< Reported by a selective acknowledgement.
+        bool fastResent;     ///< Already sent again because a later message overtook it.
+        uint32_t sentAtUs;   ///< When it was last sent, a `TimeoutClock` reading.
+    };
+
+    /// @brief A received message waiting to be passed on in order.
+    struct RxSlot {
+        uint8_t data[MaxPayload];
+        uint8_t length;
+        bool present;
+    };
+
+    IStream& baseStream;
+    uint32_t retransmitMs;        ///< Time without acknowledgement after which a message is sent again.
+
+    TxSlot txSlots[Window];
+    uint8_t txBase = 0;           ///< The oldest unacknowledged message.
+    uint8_t txNext = 0;           ///< The sequence number of the next new message.
+    uint8_t txBaseSlot = 0;       ///< The slot of `txBase`.
+
+    RxSlot rxSlots[Window];
+    uint8_t rxNext = 0;           ///< The next message to pass on.
+    uint8_t rxNextSlot = 0;       ///< The slot of `rxNext`.
+    bool ackPending = false;      ///< A data frame arrived and has not been acknowledged yet.
+
+    uint8_t rxRaw[EncodedSize];   ///< Collects the encoded frame being received.
+    size_t rxLength = 0;          ///< Bytes in `rxRaw`.
+    bool discarding = false;      ///< Dropping the rest of a frame that did not fit `rxRaw`.
+    uint8_t rxPacket[PacketSize]; ///< The decoded frame being handled.
+    uint8_t txPacket[PacketSize]; ///< The frame being sent.
+    NullStream nullStream;
+
+    uint32_t framesSent = 0;
+    uint32_t retransmissions = 0;
+
+public:
+    /// @brief Constructs a link over a byte stream.
+    /// @param stream The byte stream, shared by both directions.
+    /// @param retransmitTimeoutMs Time without acknowledgement after which a message is sent again;
+    ///        somewhat more than the round trip time of a full frame.
+    ReliableLink(IStream& stream, uint32_t retransmitTimeoutMs)
+        : baseStream(stream), retransmitMs(retransmitTimeoutMs) {
+        for (RxSlot& slot : rxSlots) {
+            slot.present = false;
+        }
+    }
+
+    /// @brief Returns the byte stream the link runs over.
+    IStream& BaseStream() { return baseStream; }
+
+    /// @brief Sends a message, waiting for room in the window if all slots are in flight.
+    /// @param data The message.
+    /// @param size Its length, at most `MaxPayload`.
+    /// @param timeout A `Timeout` object bounding the wait for room in the window.
+    /// @return False if the message is too long or the window stayed full until the timeout.
+    bool Send(const uint8_t* data, size_t size, const Timeout& timeout) {
+        if (size > MaxPayload) {
+            return false;
+        }
+        while (InFlight() >= Window) {
+            if (timeout.Expired()) {
+                return false;
+            }
+            Service(Slice(timeout));
+        }
+
+        TxSlot& slot = Tx(txNext);
+        memcpy(slot.data, data, size);
+        slot.length = static_cast<uint8_t>(size);
+        slot.acked = false;
+        slot.fastResent = false;
+        SendData(txNext, timeout);
+        txNext++;
+        return true;
+    }
+
+    /// @brief Returns the next message in order, servicing the link until it arrives.
+    /// The message stays valid, and the link holds it, until `Release`.
+    /// @param data Set to the message.
+    /// @param size Set to its length.
+    /// @param timeout A `Timeout` object bounding the wait.
+    /// @return False if no message arrived in time.
+    bool Receive(const uint8_t*& data, size_t& size, const Timeout& timeout) {
+        RxSlot& slot = rxSlots[rxNextSlot];
+        while (!slot.present) {
+            Service(Slice(timeout));
+            if (!slot.present && timeout.Expired()) {
+                return false;
+            }
+        }
+        data = slot.data;
+        size = slot.length;
+        return true;
+    }
+
+    /// @brief Passes on the message returned by `Receive`, making room for the next one.
+    void Release() {
+        RxSlot& slot = rxSlots[rxNextSlot];
+        if (slot.present) {
+            slot.present = false;
+            rxNext++;
+            rxNextSlot = static_cast<uint8_t>((rxNextSlot + 1) % Window);
+            ackPending = true; // Tell the sender about the room
+        }
+    }
+
+    /// @brief Handles the frames that arrive within `timeout`, resends overdue messages and
+    /// sends the acknowledgement. Call regularly, also while there is nothing to send.
+    void Service(const Timeout& timeout) {
+        ReceiveFrames(timeout);
+        Retransmit(timeout);
+        if (ackPending) {
+            SendFrame(0, rxNext, nullptr, 0, timeout);
+        }
+    }
+
+    /// @brief Returns the number of messages sent and not acknowledged yet.
+    size_t InFlight() const { return static_cast<uint8_t>(txNext - txBase); }
+
+    /// @brief Returns the number of frames sent, data and acknowledgements.
+    uint32_t FramesSent() const { return framesSent; }
+
+    /// @brief Returns the number of data frames sent again.
+    uint32_t Retransmissions() const { return retransmissions; }
+
+private:
+    /// @brief Returns the slot of a message in flight, `seq` in [txBase, txBase + Window).
+    TxSlot& Tx(uint8_t seq) {
+        return txSlots[(txBaseSlot + static_cast<uint8_t>(seq - txBase)) % Window];
+    }
+
+    /// @brief Limits a wait to the retransmit timeout, so overdue messages are resent while waiting.
+    Timeout Slice(const Timeout& timeout) const {
+        uint32_t remaining = timeout.RemainingMicroseconds();
+        return Timeout::Microseconds(remaining < retransmitMs * 1000 ? remaining : retransmitMs * 1000);
+    }
+
+    /// @brief Reads what has arrived and handles every complete frame.
+    void ReceiveFrames(const Timeout& timeout) {
+        if (rxLength == sizeof(rxRaw)) {
+            // The frame does not fit, drop what we have and skip ahead to its delimiter
+            rxLength = 0;
+            discarding = true;
+        }
+        size_t scanned = rxLength;
+        rxLength += baseStream.Read(rxRaw + rxLength, sizeof(rxRaw) - rxLength, timeout);
+
+        size_t start = 0;
+        while (const uint8_t* end = FindByte(rxRaw + scanned, rxLength - scanned, 0)) {
+            size_t next = end - rxRaw + 1;
+            if (discarding) {
+                discarding = false; // Tail of an oversized frame
+            } else {
+                HandleFrame(rxRaw + start, next - start);
+            }
+            start = next;
+            scanned = next;
+        }
+        memmove(rxRaw, rxRaw + start, rxLength - start);
+        rxLength -= start;
+    }
+
+    /// @brief Decodes one frame; corrupted frames fail the CRC and are ignored.
+    void HandleFrame(const uint8_t* frame, size_t size) {
+        FrameStream frameStream(frame, size, nullStream);
+        CobsFraming cobs(frameStream, rxPacket, sizeof(rxPacket), nullptr, 0);
+        const uint8_t* payload;
+        size_t length = cobs.Peek(payload, Timeout::Milliseconds(0));
+        if (length < HeaderSize) {
+            return;
+        }
+
+        uint8_t flags = payload[0];
+        uint8_t seq = payload[1];
+        uint8_t ack = payload[2];
+        uint16_t sack = static_cast<uint16_t>(payload[3] | (payload[4] << 8));
+        HandleAck(ack, sack);
+
+        if (flags & FlagData) {
+            ackPending = true; // Also for duplicates, whose acknowledgement may have been lost
+            uint8_t offset = static_cast<uint8_t>(seq - rxNext);
+            if (offset >= Window) {
+                return; // Already passed on, or beyond the window
+            }
+            RxSlot& slot = rxSlots[(rxNextSlot + offset) % Window];
+            if (!slot.present && length - HeaderSize <= MaxPayload) {
+                memcpy(slot.data, payload + HeaderSize, length - HeaderSize);
+                slot.length = static_cast<uint8_t>(length - HeaderSize);
+                slot.present = true;
+            }
+        }
+    }
+
+    /// @brief Frees acknowledged slots and resends messages a later message has overtaken.
+    void HandleAck(uint8_t ack, uint16_t sack) {
+        uint8_t advance = static_cast<uint8_t>(ack - txBase);
+        if (advance > InFlight()) {
+            return; // Stale or corrupted acknowledgement
+        }
+        txBase = ack;
+        txBaseSlot = static_cast<uint8_t>((txBaseSlot + advance) % Window);
+
+        size_t inFlight = InFlight();
+        size_t highestAcked = 0;
+        for (size_t i = 0; i < inFlight; ++i) {
+            if (sack & (1u << i)) {
+                Tx(static_cast<uint8_t>(txBase + i)).acked = true;
+                highestAcked = i + 1;
+            }
+        }
+        for (size_t i = 0; i + 1 < highestAcked; ++i) {
+            uint8_t seq = static_cast<uint8_t>(txBase + i);
+            TxSlot& slot = Tx(seq);
+            if (!slot.acked && !slot.fastResent) {
+                slot.fastResent = true;
+                retransmissions++;
+                SendData(seq, Timeout::Milliseconds(0));
+            }
+        }
+    }
+
+    /// @brief Resends unacknowledged messages whose retransmit timeout has expired.
+    /// The oldest message is resent even if the receiver reported it, as the acknowledgement
+    /// that would free its slot may have been lost; the duplicate draws a fresh one.
+    void Retransmit(const Timeout& timeout) {
+        uint32_t now = TimeoutClock::Now();
+        size_t inFlight = InFlight();
+        for (size_t i = 0; i < inFlight; ++i) {
+            uint8_t seq = static_cast<uint8_t>(txBase + i);
+            TxSlot& slot = Tx(seq);
+            if ((!slot.acked || i == 0) && now - slot.sentAtUs >= retransmitMs * 1000) {
+                slot.fastResent = false;
+                retransmissions++;
+                SendData(seq, timeout);
+            }
+        }
+    }
+
+    /// @brief Sends a data frame for the message in flight with sequence number `seq`.
+    void SendData(uint8_t seq, const Timeout& timeout) {
+        TxSlot& slot = Tx(seq);
+        slot.sentAtUs = TimeoutClock::Now();
+        SendFrame(FlagData, seq, slot.data, slot.length, timeout);
+    }
+
+    /// @brief Sends one frame carrying the current acknowledgement and an optional message.
+    void SendFrame(uint8_t flags, uint8_t seq, const uint8_t* data, size_t size, const Timeout& timeout) {
+        uint16_t sack = 0;
+        for (size_t i = 0; i < Window; ++i) {
+            if (rxSlots[(rxNextSlot + i) % Window].present) {
+                sack |= static_cast<uint16_t>(1u << i);
+            }
+        }
+        uint8_t header[HeaderSize] = {flags, seq, rxNext, static_cast<uint8_t>(sack), static_cast<uint8_t>(sack >> 8)};
+
+        CobsFraming cobs(baseStream, nullptr, 0, txPacket, sizeof(txPacket));
+        cobs.Write(header, sizeof(header), timeout);
+        if (size) {
+            cobs.Write(data, size, timeout);
+        }
+        cobs.Flush(timeout);
+        framesSent++;
+        ackPending = false; // Every frame carries the acknowledgement
+    }
+};
+
+/// @brief A `Framing` over a `ReliableLink`: reads one message of the link as the frame and
+/// sends everything written to it as one message on `Flush`. Create one per frame, for example
+/// in the `FramingFactory` of a `CommandExecutor`.
+/// @tparam Link The `ReliableLink` type.
+/// @tparam MaxPayload The largest outgoing message in bytes, at most the link's.
+template <typename Link, size_t MaxPayload = 64>
+class ReliableFraming : public Framing {
+    Link& link;
+    const uint8_t* message = nullptr; ///< The received message, held by the link until destruction.
+    size_t messageLength = 0;
+    size_t position = 0;
+    bool received = false;
+    uint8_t txBuffer[MaxPayload];
+    size_t txLength = 0;
+
+public:
+    /// @brief Constructs the framing of one frame over a link.
+    ReliableFraming(Link& reliableLink) : Framing(reliableLink.BaseStream()), link(reliableLink) {}
+
+    /// @brief Hands the received message back to the link.
+    ~ReliableFraming() {
+        if (received) {
+            link.Release();
+        }
+    }
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* window;
+        size_t available = Peek(window, timeout);
+        size_t count = size < available ? size : available;
+        memcpy(data, window, count);
+        position += count;
+        return count;
+    }
+
+    /// @brief Exposes the unread part of the message, waiting up to `timeout` for it to arrive.
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        if (!received) {
+            received = link.Receive(message, messageLength, timeout);
+            if (!received) {
+                return 0;
+            }
+        }
+        data = message + position;
+        return messageLength - position;
+    }
+
+    virtual void Consume(size_t size) override {
+        position += size;
+    }
+
+    virtual bool EndOfFrame() const override {
+        return received && position >= messageLength;
+    }
+
+    virtual size_t FramePosition() const override {
+        return position;
+    }
+
+    /// @brief Appends data to the outgoing message.
+    /// @return The number of bytes accepted; fewer than `size` once the message is full.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        size_t space = MaxPayload - txLength;
+        size_t count = size < space ? size : space;
+        memcpy(txBuffer + txLength, data, count);
+        txLength += count;
+        return count;
+    }
+
+    /// @brief Sends the outgoing message, if anything was written.
+    virtual void Flush(const Timeout& timeout) override {
+        if (txLength) {
+            link.Send(txBuffer, txLength, timeout);
+            txLength = 0;
+        }
+        link.Service(Timeout::Milliseconds(0));
+    }
+};
@@ -0,0 +1,182 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "IStream.h"
+
+/// @brief One slot of a `ResponseCache`, describing the response bytes it holds.
+struct CachedResponse {
+    uint32_t cmd;      ///< The command whose outputs are held.
+    uint32_t epoch;    ///< The command's epoch when the outputs were recorded.
+    uint16_t length;   ///< Number of recorded bytes.
+    bool valid;        ///< Set once the slot holds a complete response.
+};
+
+/// @brief A bounded cache of serialized command outputs over caller-provided storage.
+/// Commands whose lookup item has an `epoch` are cacheable: the executor records the bytes their
+/// handler writes on a miss and replays them on later requests without calling the handler, for
+/// as long as the epoch keeps its value. Only `Ok` responses that fit a slot are cached. Nothing is
+/// allocated: every slot has the same share of the byte pool, and when all slots are taken the
+/// least recently recorded one is replaced. See `StaticResponseCache`.
+class ResponseCache {
+    CachedResponse* slots;   ///< The slots.
+    size_t capacity;         ///< Number of slots.
+    uint8_t* pool;           ///< Recorded bytes, `slotSize` per slot.
+    size_t slotSize;         ///< Bytes available to each slot.
+    size_t nextVictim = 0;   ///< The slot replaced next when all are in use.
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+public:
+    /// @brief Constructs a cache over existing storage.
+    /// @param entries The slots; they must start out zeroed, i.e. empty.
+    /// @param count The number of slots.
+    /// @param bytes The byte pool shared by the slots.
+    /// @param size The size of `bytes`; each slot holds responses of up to `size / count` bytes.
+    ResponseCache(CachedResponse* entries, size_t count, uint8_t* bytes, size_t size)
+        : slots(entries), capacity(count), pool(bytes), slotSize(count ? size / count : 0) {}
+
+    /// @brief Finds the recorded outputs of a command and counts the hit or miss.
+    /// @param cmd The command code.
+    /// @param epoch The command's current epoch; outputs recorded under another epoch are stale.
+    /// @return The slot holding the outputs, or nullptr on a miss.
+    const CachedResponse* Find(uint32_t cmd, uint32_t epoch) {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (slots[i].valid && slots[i].cmd == cmd && slots[i].epoch == epoch) {
+                hits++;
+                return &slots[i];
+            }
+        }
+        misses++;
+        return nullptr;
+    }
+
+    /// @brief Takes a slot for recording the outputs of a command, clearing what it held.
+    /// The command's stale slot is reused if it has one, then a free slot, then the oldest.
+    CachedResponse& Claim(uint32_t cmd) {
+        CachedResponse* slot = nullptr;
+        for (size_t i = 0; i < capacity && !slot; ++i) {
+            if (slots[i].valid && slots[i].cmd == cmd) {
+                slot = &slots[i];
+            }
+        }
+        for (size_t i = 0; i < capacity && !slot; ++i) {
+            if (!slots[i].valid) {
+                slot = &slots[i];
+            }
+        }
+        if (!slot) {
+            slot = &slots[nextVictim];
+            nextVictim = (nextVictim + 1) % capacity;
+        }
+        slot->cmd = cmd;
+        slot->valid = false;
+        return *slot;
+    }
+
+    /// @brief Marks a claimed slot as holding the outputs of its command.
+    /// @param slot The slot returned by `Claim`.
+    /// @param epoch The command's epoch read before its handler ran.
+    /// @param length The number of bytes recorded into `Bytes(slot)`.
+    void Store(CachedResponse& slot, uint32_t epoch, size_t length) {
+        slot.epoch = epoch;
+        slot.length = static_cast<uint16_t>(length);
+        slot.valid = true;
+    }
+
+    /// @brief Returns the bytes of a slot, `SlotSize()` of them.
+    uint8_t* Bytes(const CachedResponse& slot) {
+        return pool + (&slot - slots) * slotSize;
+    }
+
+    /// @brief Returns the largest response a slot holds, in bytes.
+    size_t SlotSize() const { return slotSize < UINT16_MAX ? slotSize : UINT16_MAX; }
+
+    /// @brief Empties the cache, for example after changes that no epoch covers.
+    void Clear() {
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].valid = false;
+        }
+    }
+
+    /// @brief Returns the number of requests served from the cache.
+    uint32_t Hits() const { return hits; }
+
+    /// @brief Returns the number of requests for cacheable commands that ran their handler.
+    uint32_t Misses() const { return misses; }
+
+    /// @brief Clears the hit and miss counters.
+    void ResetCounters() {
+        hits = 0;
+        misses = 0;
+    }
+};
+
+/// @brief A `ResponseCache` with its slots and bytes stored inline.
+/// @tparam N The number of cached responses.
+/// @tparam SlotBytes The largest response a slot holds, in bytes.
+template <size_t N, size_t SlotBytes = 32>
+class StaticResponseCache : public ResponseCache {
+    static_assert(N > 0, "A response cache needs at least one slot");
+
+    CachedResponse entries[N] = {};
+    uint8_t bytes[N * SlotBytes];
+
+public:
+    /// @brief Constructs an empty cache.
+    StaticResponseCache() : ResponseCache(entries, N, bytes, sizeof(bytes)) {}
+};
+
+/// @brief A stream that passes writes through to another stream and records them as well.
+/// The executor runs a cacheable command over it on a cache miss. Recording stops for good once
+/// the buffer is full, so a response that does not fit is sent but not cached.
+class ResponseRecorder : public IStream {
+    IStream& inner;          ///< The stream the response is sent on.
+    uint8_t* buffer;         ///< Receives a copy of the written bytes.
+    size_t capacity;         ///< Size of `buffer`.
+    size_t length = 0;       ///< Bytes recorded so far.
+    bool overflowed = false;
+
+public:
+    /// @brief Constructs a recorder over the stream carrying the response.
+    /// @param stream The stream the response is sent on; reads are passed to it as well.
+    /// @param buf The buffer receiving the copy.
+    /// @param size Size of `buf` in bytes.
+    ResponseRecorder(IStream& stream, uint8_t* buf, size_t size)
+        : inner(stream), buffer(buf), capacity(size) {}
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        return inner.Read(data, size, timeout);
+    }
+
+    virtual size_t Peek(const uint8_t*& data, const Timeout& timeout) override {
+        return inner.Peek(data, timeout);
+    }
+
+    virtual void Consume(size_t size) override {
+        inner.Consume(size);
+    }
+
+    /// @brief Writes to the inner stream and records the bytes it accepted.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        size_t written = inner.Write(data, size, timeout);
+        if (written > capacity - length || written < size) {
+            overflowed = true;
+        }
+        if (!overflowed) {
+            memcpy(buffer + length, data, written);
+            length += written;
+        }
+        return written;
+    }
+
+    virtual void Flush(const Timeout& timeout) override {
+        inner.Flush(timeout);
+    }
+
+    /// @brief Returns true if the whole response was recorded.
+    bool Complete() const { return !overflowed; }
+
+    /// @brief Returns the number of bytes recorded.
+    size_t Length() const { return length; }
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// @brief Finds the first occurrence of `value` in a block of bytes.
+/// @return A pointer to the matching byte, or nullptr if it does not occur.
+inline const uint8_t* FindByte(const uint8_t* data, size_t size, uint8_t value) {
+    return static_cast<const uint8_t*>(memchr(data, value, size));
+}
+
+/// @brief Finds the first byte in a block that equals either `a` or `b`.
+/// Host builds with SSE2 compare 16 bytes per step; other targets use a plain loop.
+/// @return A pointer to the matching byte, or nullptr if neither occurs.
+inline const uint8_t* FindEither(const uint8_t* data, size_t size, uint8_t a, uint8_t b) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i matchA = _mm_set1_epi8(static_cast<char>(a));
+    const __m128i matchB = _mm_set1_epi8(static_cast<char>(b));
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, matchA), _mm_cmpeq_epi8(chunk, matchB)));
+        if (mask) {
+            return data + i + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == a || data[i] == b) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
@@ -9,7 +9,8 @@
 class SerialStream : public IStream {
 public:
     /// @brief Reads data from the UART into a specified buffer.
-    /// This method will attempt to read up to `size` bytes within the specified timeout period.
+    /// This method waits up to the timeout for data to arrive, then reads as many bytes as are
+    /// available, up to `size`. It does not wait for more once at least one byte has been read.
     /// @param data A pointer to the buffer where the read data will be stored.
     /// @param size The maximum number of bytes to read.
     /// @param timeout A `Timeout` object specifying the maximum time allowed for reading.
@@ -17,13 +18,19 @@ public:
     virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
         uint8_t* byteData = static_cast<uint8_t*>(data);
         size_t bytesRead = 0;
+        TimeoutCheck<> deadline(timeout); // Spins on the UART, the clock need not be read every time
 
-        // Continue reading while we have time and data left to read
-        while (!timeout.Expired() && bytesRead < size) {
-            if (Serial.available() > 0) {
-                bytesRead += Serial.readBytes(byteData + bytesRead, size - bytesRead);
+        // Check at least once, so a zero timeout still picks up what has arrived,
+        // then continue while we have time and data left to read
+        do {
+            int available = Serial.available();
+            if (available > 0) {
+                size_t count = size - bytesRead < (size_t)available ? size - bytesRead : (size_t)available;
+                bytesRead += Serial.readBytes(byteData + bytesRead, count);
+            } else if (bytesRead > 0) {
+                break; // Return what has arrived instead of waiting for the rest
             }
-        }
+        } while (!deadline.Expired() && bytesRead < size);
 
         return bytesRead;
     }
@@ -37,11 +44,12 @@ public:
     virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
         const uint8_t* byteData = static_cast<const uint8_t*>(data);
         size_t bytesWritten = 0;
+        TimeoutCheck<> deadline(timeout);
 
-        // Write data within the specified timeout
-        while (!timeout.Expired() && bytesWritten < size) {
+        // Write data within the specified timeout, trying at least once
+        do {
             bytesWritten += Serial.write(byteData + bytesWritten, size - bytesWritten);
-        }
+        } while (!deadline.Expired() && bytesWritten < size);
 
         return bytesWritten;
     }
@@ -53,9 +61,12 @@ public:
     virtual void Flush(const Timeout& timeout) override {
 
         // Wait for Serial to finish transmitting or until timeout expires
-        while (!timeout.Expired() && Serial.availableForWrite() < 64) {
+        TimeoutCheck<> deadline(timeout);
+        while (!deadline.Expired() && Serial.availableForWrite() < 64) {
             // Do nothing, just wait for Serial to finish transmitting
         }
-        Serial.flush();
+        if (!timeout.Expired()) {
+            Serial.flush(); // Blocks until the last byte is out, so only wait within the timeout
+        }
     }
 };
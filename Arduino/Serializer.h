@@ -1,79 +1,165 @@
 #pragma once
 #include "IStream.h"
 #include "Timeout.h"
-#include <type_traits>
-#include <typeindex>
+#include "ByteSpan.h"
+#include "Hex.h"
+#include "CommandStructures.h"
+#include <cstdint>
+#include <cstddef>
 
+// Every serializable type owns a fixed slot in a SerializerTable. The slot of T is known at
+// compile time, so a lookup is a single array index instead of a search, and using a type
+// without a slot fails to compile.
 template <typename T>
-int type_id()
+struct SerializerSlot
 {
-    // The address of a unique static variable in each template instantiation serves as a unique ID.
-    static const int id = []
-    {
-        static int counter = 0;
-        return ++counter;
-    }();
-    return reinterpret_cast<int>(&id);
-}
+    static_assert(sizeof(T) == 0, "Type not supported for serialization, give it a slot with SERIALIZER_SLOT");
+};
+
+#define SERIALIZER_SLOT(Type, Index)                \
+    template <>                                     \
+    struct SerializerSlot<Type>                     \
+    {                                               \
+        static constexpr size_t index = Index;      \
+    };
+
+SERIALIZER_SLOT(int, 0)
+SERIALIZER_SLOT(unsigned int, 1)
+SERIALIZER_SLOT(int64_t, 2)
+SERIALIZER_SLOT(uint64_t, 3)
+SERIALIZER_SLOT(float, 4)
+SERIALIZER_SLOT(ConstByteSpan, 5)
+SERIALIZER_SLOT(ByteBuffer, 6)
+SERIALIZER_SLOT(CommandRequest, 7)
+SERIALIZER_SLOT(CommandResult, 8)
+SERIALIZER_SLOT(ResponseHeader, 9)
+SERIALIZER_SLOT(Hex, 10)
+SERIALIZER_SLOT(ConstSpan<int16_t>, 11)
+SERIALIZER_SLOT(SpanBuffer<int16_t>, 12)
+SERIALIZER_SLOT(ConstSpan<uint16_t>, 13)
+SERIALIZER_SLOT(SpanBuffer<uint16_t>, 14)
+SERIALIZER_SLOT(ConstSpan<int32_t>, 15)
+SERIALIZER_SLOT(SpanBuffer<int32_t>, 16)
+SERIALIZER_SLOT(ConstSpan<uint32_t>, 17)
+SERIALIZER_SLOT(SpanBuffer<uint32_t>, 18)
+SERIALIZER_SLOT(ConstSpan<float>, 19)
+SERIALIZER_SLOT(SpanBuffer<float>, 20)
+SERIALIZER_SLOT(ConstText, 21)
+SERIALIZER_SLOT(TextBuffer, 22)
 
-#define SERIALIZER_ENTRY(Type, SerializeFunc, DeserializeFunc)                               \
-    {                                                                                        \
-        type_id<Type>(),                                                                     \
-        [](const Serializer &s, IStream &stream, const void *item, const Timeout &timeout) { \
-            return SerializeFunc(s, stream, *static_cast<const Type *>(item), timeout);      \
-        },                                                                                   \
-        [](const Serializer &s, IStream &stream, void *item, const Timeout &timeout) {       \
-            return DeserializeFunc(s, stream, *static_cast<Type *>(item), timeout);          \
-        }}
+constexpr size_t SerializerSlotCount = 23;
+
+#define SERIALIZER_ENTRY(Type, SerializeFunc, DeserializeFunc)                                   \
+    SerializerEntry                                                                              \
+    {                                                                                            \
+        SerializerSlot<Type>::index,                                                             \
+        {                                                                                        \
+            [](const Serializer &s, IStream &stream, const void *item, const Timeout &timeout) { \
+                return SerializeFunc(s, stream, *static_cast<const Type *>(item), timeout);      \
+            },                                                                                   \
+            [](const Serializer &s, IStream &stream, void *item, const Timeout &timeout) {       \
+                return DeserializeFunc(s, stream, *static_cast<Type *>(item), timeout);          \
+            }}                                                                                   \
+    }
 
 class Serializer;
 struct SerializeItem
 {
-    int id;
     bool (*serializer)(const Serializer &serializer, IStream &stream, const void *item, const Timeout &timeout);
     bool (*deserializer)(const Serializer &serializer, IStream &stream, void *item, const Timeout &timeout);
 };
 
-// Serializer class to handle both serialization and deserialization
+// A SerializeItem together with the slot of the type it handles, as produced by SERIALIZER_ENTRY
+struct SerializerEntry
+{
+    size_t slot;
+    SerializeItem item;
+};
+
+// The functions of one format, indexed by SerializerSlot. Types the format does not handle have null entries.
+struct SerializerTable
+{
+    SerializeItem items[SerializerSlotCount];
+};
+
+// Deliberately not constexpr: reaching it while building a constexpr table is a compile error
+inline void DuplicateSerializerEntry() {}
+
+// Builds a table from a list of SERIALIZER_ENTRY items. Declare the result constexpr so
+// duplicate entries are rejected at compile time.
+template <size_t N>
+constexpr SerializerTable MakeSerializerTable(const SerializerEntry (&entries)[N])
+{
+    SerializerTable table{};
+    for (size_t i = 0; i < N; ++i)
+    {
+        SerializeItem &item = table.items[entries[i].slot];
+        if (item.serializer || item.deserializer)
+        {
+            DuplicateSerializerEntry();
+        }
+        item = entries[i].item;
+    }
+    return table;
+}
+
+// Serializer class to handle both serialization and deserialization.
+// The format is chosen at runtime by the table it is constructed with.
 class Serializer
 {
-    const SerializeItem *serializers;
-    size_t count;
+    const SerializerTable *table;
 
 public:
-    Serializer(const SerializeItem *serializers, size_t count)
-        : serializers(serializers), count(count) {}
+    constexpr Serializer(const SerializerTable &table)
+        : table(&table) {}
 
     template <typename T>
     bool Serialize(IStream &stream, const T &item, const Timeout &timeout) const
     {
-        int id = type_id<T>();
-        for (size_t i = 0; i < count; ++i)
+        const auto &entry = table->items[SerializerSlot<T>::index];
+        if (!entry.serializer)
         {
-            const auto &entry = serializers[i];
-            if (entry.id == id)
-            {
-                return entry.serializer(*this, stream, static_cast<const void *>(&item), timeout);
-            }
+            return false; // Not supported by this format
         }
-        printf("Type not supported for serialization\n");
-        return false;
+        return entry.serializer(*this, stream, static_cast<const void *>(&item), timeout);
     }
 
     template <typename T>
     bool Deserialize(IStream &stream, T &item, const Timeout &timeout) const
     {
-        int id = type_id<T>();
-        for (size_t i = 0; i < count; ++i)
+        const auto &entry = table->items[SerializerSlot<T>::index];
+        if (!entry.deserializer)
         {
-            const auto &entry = serializers[i];
-            if (entry.id == id)
-            {
-                return entry.deserializer(*this, stream, static_cast<void *>(&item), timeout);
-            }
+            return false; // Not supported by this format
         }
-        printf("Type not supported for deserialization\n");
-        return false;
+        return entry.deserializer(*this, stream, static_cast<void *>(&item), timeout);
+    }
+};
+
+// Serializer bound to one format at compile time. Serialize and Deserialize resolve to a
+// direct call of the format's function, and types the format does not handle fail to compile.
+// It still converts to a Serializer, so it can be handed to an ObjectStream.
+template <const SerializerTable &Table>
+class StaticSerializer : public Serializer
+{
+public:
+    constexpr StaticSerializer()
+        : Serializer(Table) {}
+
+    template <typename T>
+    bool Serialize(IStream &stream, const T &item, const Timeout &timeout) const
+    {
+        constexpr auto serializer = Table.items[SerializerSlot<T>::index].serializer;
+        static_assert(serializer != nullptr, "Type not supported for serialization by this format");
+        return serializer(*this, stream, static_cast<const void *>(&item), timeout);
+    }
+
+    template <typename T>
+    bool Deserialize(IStream &stream, T &item, const Timeout &timeout) const
+    {
+        constexpr auto deserializer = Table.items[SerializerSlot<T>::index].deserializer;
+        static_assert(deserializer != nullptr, "Type not supported for deserialization by this format");
+        return deserializer(*this, stream, static_cast<void *>(&item), timeout);
     }
 };
 
@@ -82,4 +168,5 @@ class SerializerFactory
 {
 public:
     static Serializer CreateAsciiSerializer();
+    static Serializer CreateBinarySerializer();
 };
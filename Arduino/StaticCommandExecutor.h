@@ -0,0 +1,54 @@
+#pragma once
+#include <tuple>
+#include "CommandExecutorCore.h"
+
+/// @brief A command executor with framing, command list and serializer fixed at compile time.
+/// It behaves like `CommandExecutor`, but builds the framing of each frame in place on the stack
+/// from the constructor arguments given here. There is no `std::function`, no type-erased callback
+/// and no heap use on the `Tick` path. With a `final` command list such as `ConstexprCommandList`
+/// the lookup is a direct call, and with a `StaticSerializer` so are request and response (de)serialization.
+/// Use `MakeCommandExecutor` to deduce the template arguments.
+/// @tparam FramingT The framing, constructed as `FramingT(stream, framingArgs...)` for every frame.
+/// @tparam CommandListT The command list type.
+/// @tparam SerializerT The serializer type.
+/// @tparam FramingArgs The types of the framing constructor arguments after the stream.
+template <typename FramingT, typename CommandListT, typename SerializerT, typename... FramingArgs>
+class StaticCommandExecutor
+    : public CommandExecutorCore<StaticCommandExecutor<FramingT, CommandListT, SerializerT, FramingArgs...>, CommandListT, SerializerT> {
+    using Core = CommandExecutorCore<StaticCommandExecutor, CommandListT, SerializerT>;
+    friend Core;
+
+    std::tuple<FramingArgs...> framingArgs; ///< Arguments passed to the framing constructor after the stream.
+
+public:
+    /// @brief Constructs a `StaticCommandExecutor`.
+    /// @param stream The base stream used for communication.
+    /// @param cmdList The command list for looking up and dispatching commands.
+    /// @param serializer The serializer for requests, responses and command arguments.
+    /// @param args Arguments for the framing constructor, after the stream; e.g. the buffers of `CobsFraming`.
+    StaticCommandExecutor(IStream& stream, const CommandListT& cmdList, SerializerT& serializer, FramingArgs... args)
+        : Core(stream, cmdList, serializer), framingArgs(args...) {}
+
+private:
+    /// @brief Constructs the framing over `stream` and runs `body` with it.
+    template <typename Body>
+    void WithFraming(IStream& stream, Body&& body) {
+        std::apply([&stream, &body](FramingArgs... args) {
+            FramingT framing(stream, args...);
+            body(framing);
+        }, framingArgs);
+    }
+};
+
+/// @brief Creates a `StaticCommandExecutor`, deducing the command list, serializer and framing argument types.
+/// @tparam FramingT The framing type, which must be given explicitly.
+/// @param stream The base stream used for communication.
+/// @param cmdList The command list for looking up and dispatching commands.
+/// @param serializer The serializer for requests, responses and command arguments.
+/// @param args Arguments for the framing constructor, after the stream.
+/// @return The executor.
+template <typename FramingT, typename CommandListT, typename SerializerT, typename... FramingArgs>
+StaticCommandExecutor<FramingT, CommandListT, SerializerT, FramingArgs...>
+MakeCommandExecutor(IStream& stream, const CommandListT& cmdList, SerializerT& serializer, FramingArgs... args) {
+    return StaticCommandExecutor<FramingT, CommandListT, SerializerT, FramingArgs...>(stream, cmdList, serializer, args...);
+}
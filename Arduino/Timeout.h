@@ -1,52 +1,101 @@
 #pragma once
-#include <Arduino.h>
 #include <cstdint>
+#include "Clock.h"
 
-/// @brief A utility class for managing timeouts based on elapsed milliseconds.
-/// This class is designed to handle unsigned integer overflow gracefully, 
-/// allowing for reliable timeout behavior even on systems with 32-bit millisecond counters.
+/// @brief A utility class for managing timeouts based on elapsed microseconds.
+/// Time is read from the `TimeoutClock` policy, a free-running 32-bit microsecond counter. The
+/// elapsed time is computed modulo 2^32, so a timeout behaves correctly across the counter's
+/// wraparound as long as it is shorter than `MaxMicroseconds`, about 35 minutes.
+/// A zero timeout is expired from the start and never reads the clock.
 class Timeout {
-    const uint64_t startTimeMs;   ///< The timestamp (in milliseconds) when the timeout was created.
-    const uint64_t timeoutMs;     ///< The duration of the timeout (in milliseconds).
+    const uint32_t startUs;      ///< The clock reading (in microseconds) when the timeout was created.
+    const uint32_t durationUs;   ///< The duration of the timeout (in microseconds), or `NeverUs`.
+
+    static constexpr uint32_t NeverUs = UINT32_MAX; ///< Marks a timeout that never expires.
 
 public:
+    /// @brief The longest timeout that is measured, longer ones are shortened to it.
+    static constexpr uint32_t MaxMicroseconds = UINT32_MAX / 2;
+
     /// @brief Creates a Timeout object with a specified duration.
     /// @param ms The timeout duration in milliseconds.
     /// @return A Timeout object that starts at the current time and expires after the given duration.
-    static Timeout Milliseconds(uint64_t ms) {
-        return Timeout(CurrentMilliseconds(), ms);
+    static Timeout Milliseconds(uint32_t ms) {
+        return Microseconds(ms < MaxMicroseconds / 1000 ? ms * 1000 : MaxMicroseconds);
     }
 
-    /// @brief Constructs a Timeout object with a specific start time and duration.
-    /// @param startMs The start time in milliseconds.
-    /// @param durationMs The duration of the timeout in milliseconds.
-    Timeout(uint64_t startMs, uint64_t durationMs) 
-        : startTimeMs(startMs), timeoutMs(durationMs) {}
+    /// @brief Creates a Timeout object with a specified duration.
+    /// @param us The timeout duration in microseconds.
+    /// @return A Timeout object that starts at the current time and expires after the given duration.
+    static Timeout Microseconds(uint32_t us) {
+        if (us == 0) {
+            return Timeout(0, 0);
+        }
+        return Timeout(TimeoutClock::Now(), us < MaxMicroseconds ? us : MaxMicroseconds);
+    }
+
+    /// @brief Returns a timeout that never expires.
+    static const Timeout& Never() {
+        static const Timeout never(0, NeverUs);
+        return never;
+    }
 
     /// @brief Checks if the timeout has expired.
-    /// This method is safe for systems with 32-bit millisecond timers, as it accounts for overflow.
+    /// This method is safe across the wraparound of the clock, as it only uses the elapsed time.
     /// @return True if the timeout has expired, false otherwise.
     bool Expired() const {
-        return (CurrentMilliseconds() - startTimeMs) >= timeoutMs;
+        if (durationUs == 0 || durationUs == NeverUs) {
+            return durationUs == 0;
+        }
+        return TimeoutClock::Now() - startUs >= durationUs;
+    }
+
+    /// @brief Gets the remaining time until the timeout expires, in microseconds.
+    /// @return The remaining time in microseconds, 0 if the timeout has expired, or `UINT32_MAX` if it never does.
+    uint32_t RemainingMicroseconds() const {
+        if (durationUs == 0 || durationUs == NeverUs) {
+            return durationUs;
+        }
+        uint32_t elapsed = TimeoutClock::Now() - startUs;
+        return elapsed < durationUs ? durationUs - elapsed : 0;
     }
 
     /// @brief Gets the remaining time until the timeout expires, in milliseconds.
-    /// If the timeout has already expired, this method returns 0.
+    /// A partial millisecond counts as a whole one, so the result is only 0 once the timeout has expired.
     /// @return The remaining time in milliseconds, or 0 if the timeout has expired.
-    uint64_t RemainingMilliseconds() const {
-        if (Expired()) {
-            return 0;
-        } else {
-            return timeoutMs - (CurrentMilliseconds() - startTimeMs);
-        }
+    uint32_t RemainingMilliseconds() const {
+        uint32_t remaining = RemainingMicroseconds();
+        return remaining / 1000 + (remaining % 1000 != 0);
     }
 
 private:
-    /// @brief Retrieves the current time in milliseconds.
-    /// This function should be replaced with the platform-specific millisecond counter,
-    /// such as Arduino's millis() function.
-    /// @return The current time in milliseconds.
-    static uint32_t CurrentMilliseconds() {
-        return millis();  // Replace with platform-specific timing function.
+    /// @brief Constructs a Timeout object with a specific start time and duration.
+    /// @param start The clock reading in microseconds the timeout is measured from.
+    /// @param duration The duration of the timeout in microseconds.
+    Timeout(uint32_t start, uint32_t duration)
+        : startUs(start), durationUs(duration) {}
+};
+
+/// @brief Checks a timeout from a busy loop, reading the clock only on every `Stride`-th check.
+/// Loops that spin on a UART register check their timeout far more often than it can expire;
+/// this keeps the clock read (on AVR a `micros()` call with interrupts disabled) off most iterations.
+/// The first check always reads the clock, so a zero timeout still ends the loop at once.
+/// @tparam Stride The number of checks per clock read.
+template <uint8_t Stride = 16>
+class TimeoutCheck {
+    const Timeout& timeout;
+    uint8_t countdown = 1;
+    bool expired = false;
+
+public:
+    explicit TimeoutCheck(const Timeout& t) : timeout(t) {}
+
+    /// @brief Returns true if the timeout had expired at the last clock read.
+    bool Expired() {
+        if (!expired && --countdown == 0) {
+            countdown = Stride;
+            expired = timeout.Expired();
+        }
+        return expired;
     }
 };
@@ -0,0 +1,197 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "CommandList.h"
+
+/// @file TypedCommand.h
+/// @brief Commands written as typed functions, with their argument and output marshalling
+/// generated at compile time.
+///
+///     float Scale(int raw, float gain) { return raw * gain; }
+///     CommandResultCodes ReadSensor(int channel, int& value);
+///
+///     constexpr CommandLookupItem commands[] = {
+///         Command<10, Scale>(),
+///         Command<11, ReadSensor>(),
+///     };
+///
+/// Parameters taken by value or const reference are arguments, read in order from the request.
+/// Parameters taken by non-const reference are outputs. A handler returning `void` always
+/// succeeds, one returning `CommandResultCodes` reports its own result, and any other return
+/// type is an output as well. Outputs are written only if the result is `Ok`: the return value
+/// first, then the reference parameters in order. An argument that cannot be read, or an output
+/// that cannot be written, makes the result `SerializeError` without calling the handler or
+/// writing further outputs. Reads and writes use the request's `ObjectStream::Deadline`.
+///
+/// Every type involved needs a serializer slot. Arguments are numbers and `Hex`, read by value, or
+/// `const char*` and `ConstSpan<T>`, read into the request's arena (see `ObjectStream::ReadString`
+/// and `ReadArray`) and valid until the end of the `Tick`. A `const char*` output is written as a
+/// string; one the handler left null is written empty. The generated command also carries a schema of its signature, which clients fetch with
+/// `BuiltinDescribe`.
+
+/// @brief Set in a schema entry for an output; the low byte is the `SerializerSlot` index of its type.
+constexpr uint16_t SchemaOutput = 0x100;
+
+/// @brief The `I`-th type of a parameter pack.
+template <size_t I, typename T, typename... Rest>
+struct TypeAt {
+    using type = typename TypeAt<I - 1, Rest...>::type;
+};
+
+template <typename T, typename... Rest>
+struct TypeAt<0, T, Rest...> {
+    using type = T;
+};
+
+/// @brief True for a parameter that receives an output, a non-const lvalue reference.
+template <typename P>
+constexpr bool IsOutputParameter = std::is_lvalue_reference<P>::value &&
+                                   !std::is_const<typename std::remove_reference<P>::type>::value;
+
+/// @brief The type a parameter's value is held in while the command runs.
+template <typename P>
+using ParameterValue = typename std::remove_cv<typename std::remove_reference<P>::type>::type;
+
+/// @brief The serializer slot a parameter of type `T` travels as; C strings travel as `ConstText`.
+template <typename T>
+struct WireSlot : SerializerSlot<T> {};
+
+template <>
+struct WireSlot<const char*> : SerializerSlot<ConstText> {};
+
+/// @brief True for the types an argument can be read into: values, and views into the arena.
+template <typename T>
+struct IsArgument : std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_same<T, Hex>::value ||
+                                                     std::is_same<T, const char*>::value> {};
+
+template <typename T>
+struct IsArgument<ConstSpan<T>> : std::true_type {};
+
+/// @brief The schema entry of a parameter or return type, see `SchemaOutput`.
+template <typename T, bool Output>
+constexpr uint16_t SchemaEntry() {
+    using Value = ParameterValue<T>;
+    static_assert(Output || IsArgument<Value>::value,
+                  "Typed command arguments must be numbers, Hex, const char* or ConstSpan");
+    return static_cast<uint16_t>(WireSlot<Value>::index | (Output ? SchemaOutput : 0));
+}
+
+/// @brief Reads an argument taken by value.
+template <typename T>
+bool ReadArgument(ObjectStream& objStream, T& value, const Timeout& timeout) {
+    return objStream.Read(value, timeout);
+}
+
+/// @brief Reads a string argument into the arena.
+inline bool ReadArgument(ObjectStream& objStream, const char*& text, const Timeout& timeout) {
+    return objStream.ReadString(text, timeout);
+}
+
+/// @brief Reads an array argument into the arena.
+template <typename T>
+bool ReadArgument(ObjectStream& objStream, ConstSpan<T>& span, const Timeout& timeout) {
+    return objStream.ReadArray(span.data, span.size, timeout);
+}
+
+/// @brief Writes an output.
+template <typename T>
+bool WriteOutputValue(ObjectStream& objStream, const T& value, const Timeout& timeout) {
+    return objStream.Write(value, timeout);
+}
+
+/// @brief Writes a string output.
+inline bool WriteOutputValue(ObjectStream& objStream, const char* text, const Timeout& timeout) {
+    return objStream.WriteString(text, timeout);
+}
+
+/// @brief The schema of a typed command: the number of entries, then one entry per argument and
+/// output in wire order, the return value before the parameters.
+template <size_t N>
+struct CommandSchema {
+    uint16_t entries[N + 1];
+};
+
+/// @brief Builds the schema of a handler returning `R` and taking `Params`.
+template <typename R, typename... Params>
+constexpr auto MakeCommandSchema() {
+    constexpr bool returnOutput = !std::is_void<R>::value && !std::is_same<R, CommandResultCodes>::value;
+    CommandSchema<sizeof...(Params) + returnOutput> schema{};
+    size_t count = 0;
+    if constexpr (returnOutput) {
+        schema.entries[++count] = SchemaEntry<R, true>();
+    }
+    ((schema.entries[++count] = SchemaEntry<Params, IsOutputParameter<Params>>()), ...);
+    schema.entries[0] = static_cast<uint16_t>(count);
+    return schema;
+}
+
+/// @brief Generates the `CommandFunc` and schema of a typed handler, see `Command`.
+template <auto Handler>
+struct TypedCommand;
+
+template <typename R, typename... Params, R (*Handler)(Params...)>
+struct TypedCommand<Handler> {
+    /// @brief The signature, see `CommandSchema`.
+    static constexpr auto schema = MakeCommandSchema<R, Params...>();
+
+    /// @brief Reads the arguments, calls the handler and writes its outputs.
+    static CommandResultCodes Execute(ObjectStream& objStream) {
+        return Read<0>(objStream, objStream.Deadline());
+    }
+
+private:
+    /// @brief Reads the argument of parameter `I` and the ones after it, one local each, then calls the handler.
+    template <size_t I, typename... Values>
+    static CommandResultCodes Read(ObjectStream& objStream, const Timeout& timeout, Values&... values) {
+        if constexpr (I == sizeof...(Params)) {
+            return Call(objStream, timeout, values...);
+        } else {
+            using Param = typename TypeAt<I, Params...>::type;
+            ParameterValue<Param> value{};
+            if constexpr (!IsOutputParameter<Param>) {
+                if (!ReadArgument(objStream, value, timeout)) {
+                    return SerializeError;
+                }
+            }
+            return Read<I + 1>(objStream, timeout, values..., value);
+        }
+    }
+
+    static CommandResultCodes Call(ObjectStream& objStream, const Timeout& timeout, ParameterValue<Params>&... values) {
+        CommandResultCodes result = Ok;
+        if constexpr (std::is_void<R>::value) {
+            Handler(values...);
+        } else if constexpr (std::is_same<R, CommandResultCodes>::value) {
+            result = Handler(values...);
+        } else {
+            R output = Handler(values...);
+            if (!WriteOutputValue(objStream, output, timeout)) {
+                return SerializeError;
+            }
+        }
+        if (result != Ok) {
+            return result;
+        }
+        return (WriteOutput<Params>(objStream, values, timeout) && ...) ? Ok : SerializeError;
+    }
+
+    template <typename Param>
+    static bool WriteOutput(ObjectStream& objStream, const ParameterValue<Param>& value, const Timeout& timeout) {
+        if constexpr (IsOutputParameter<Param>) {
+            return WriteOutputValue(objStream, value, timeout);
+        } else {
+            return true;
+        }
+    }
+};
+
+/// @brief Creates the lookup item of a typed command.
+/// @tparam Id The command code.
+/// @tparam Handler The handler, a function as described in `TypedCommand.h`.
+/// @param epoch Makes the command cacheable, see `CommandLookupItem`; it must then take no arguments.
+/// @return The lookup item, usable in a `constexpr` command table.
+template <uint32_t Id, auto Handler>
+constexpr CommandLookupItem Command(const uint32_t* epoch = nullptr) {
+    return CommandLookupItem{Id, &TypedCommand<Handler>::Execute, nullptr, epoch, TypedCommand<Handler>::schema.entries};
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+
+/// @file Benchmark.h
+/// @brief A tiny self-calibrating benchmark harness for host builds.
+/// Each benchmark body is run in growing batches until a batch takes at least the
+/// requested measuring time, and the result is reported as ns/op and ops/sec.
+
+/// @brief Prevents the compiler from optimizing away a computed value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief The outcome of a single benchmark run.
+struct BenchmarkResult {
+    const char* name;     ///< Name printed in the report.
+    uint64_t iterations;  ///< Number of iterations in the measured batch.
+    double nsPerOp;       ///< Average time per iteration in nanoseconds.
+    double opsPerSec;     ///< Iterations per second.
+};
+
+/// @brief Prints the table header matching `PrintResult`.
+inline void PrintHeader(const char* title) {
+    printf("\n== %s\n", title);
+    printf("%-48s %12s %14s %14s\n", "benchmark", "iterations", "ns/op", "ops/sec");
+}
+
+/// @brief Prints one benchmark result as a table row.
+inline void PrintResult(const BenchmarkResult& result) {
+    printf("%-48s %12llu %14.1f %14.0f\n", result.name,
+           static_cast<unsigned long long>(result.iterations), result.nsPerOp, result.opsPerSec);
+}
+
+/// @brief Runs `body` repeatedly and measures the average time per call.
+/// @param name Name printed in the report.
+/// @param body A callable executed once per iteration.
+/// @param minMs The minimum duration of the measured batch in milliseconds.
+/// @return The measured result, which is also printed.
+template <typename Body>
+BenchmarkResult RunBenchmark(const char* name, Body&& body, uint32_t minMs = 200) {
+    using Clock = std::chrono::steady_clock;
+    const auto minDuration = std::chrono::milliseconds(minMs);
+
+    // Warm up caches and branch predictors before measuring
+    for (int i = 0; i < 100; ++i) {
+        body();
+    }
+
+    uint64_t iterations = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        auto elapsed = Clock::now() - start;
+
+        if (elapsed >= minDuration || iterations >= (1ull << 40)) {
+            double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+            BenchmarkResult result{name, iterations, ns / iterations, iterations * 1e9 / ns};
+            PrintResult(result);
+            return result;
+        }
+        iterations *= 2;
+    }
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+#include "CaptureReplay.h"
+#include "LoopbackStream.h"
+#include "NewLineFraming.h"
+#include "StaticCommandExecutor.h"
+#include "TypedCommand.h"
+#include "ASCIISerializers.h"
+
+// Replays a traffic capture through a host build of the executor and reports per-command latency.
+// The command table below stands in for the device's: to replay a field unit's traffic, build this
+// tool with the application's command table, framing and serializer. Without a capture file a
+// session with the sample commands is recorded into a CaptureRing first, as a device would.
+// Usage: capture_replay [capture file] [speed]
+//   speed: 1 replays at the captured rate (the default), 10 ten times faster, 0 as fast as possible
+
+using Clock = std::chrono::steady_clock;
+
+static int Add(int a, int b)
+{
+    return a + b;
+}
+
+static CommandResultCodes Readings(ObjectStream& objStream)
+{
+    const uint16_t readings[] = {512, 1023, 7, 330, 12, 870, 64, 255};
+    return objStream.WriteArray(readings, 8, objStream.Deadline()) ? Ok : SerializeError;
+}
+
+static int Checksum(const char* name, ConstSpan<int32_t> values)
+{
+    int sum = 0;
+    for (const char* c = name; *c; ++c)
+        sum += *c;
+    for (size_t i = 0; i < values.size; ++i)
+        sum += values.data[i];
+    return sum;
+}
+
+static constexpr CommandLookupItem replayCommands[] = {
+    Command<1, Add>(),
+    {2, Readings},
+    Command<3, Checksum>(),
+};
+static constexpr auto commandList = MakeCommandList(replayCommands);
+
+using ReplayExecutor = StaticCommandExecutor<NewLineFraming, std::remove_const<decltype(commandList)>::type, AsciiSerializer>;
+
+/// @brief An executor set up as on the device, serving a stream.
+struct Device
+{
+    AsciiSerializer serializer;
+    uint8_t frameBuffer[256];
+    StaticArena<256> arena;
+    ReplayExecutor executor;
+
+    explicit Device(IStream& stream) : executor(stream, commandList, serializer)
+    {
+        executor.EnableNonBlocking(frameBuffer, sizeof(frameBuffer), '\n');
+        executor.EnableArena(arena);
+    }
+};
+
+// Records a session of sample requests arriving 200 to 800 us apart, some split across reads
+static std::vector<uint8_t> RecordSession()
+{
+    static const char* const requests[] = {
+        "1 1200 34\n",
+        "2\n",
+        "3 \"motor-left\" 4 10 20 30 40\n",
+        "1 -5 5\n",
+        "2\n1 7 8\n", // Two frames arriving in one read
+        "2 1 3 4\n",   // A batch of two requests in one frame
+    };
+
+    LoopbackStream line;
+    StaticCaptureRing<65536> ring;
+    CaptureStream capture(line, ring);
+    Device device(capture);
+
+    srand(1);
+    Clock::time_point due = Clock::now();
+    for (int i = 0; i < 1000; ++i)
+    {
+        const char* request = requests[rand() % 6];
+        size_t length = strlen(request);
+        size_t split = rand() % 4 == 0 ? length / 2 : length;
+        due += std::chrono::microseconds(200 + rand() % 600);
+        while (Clock::now() < due)
+            device.executor.Tick(Timeout::Milliseconds(0));
+        line.Feed(request, split);
+        device.executor.Tick(Timeout::Milliseconds(0));
+        line.Feed(request + split, length - split);
+        for (int tick = 0; tick < 3; ++tick)
+            device.executor.Tick(Timeout::Milliseconds(0));
+    }
+
+    LoopbackStream dump;
+    ring.Dump(dump, Timeout::Milliseconds(100));
+    printf("recorded %zu bytes of capture, %u records dropped\n", dump.Written().size(), ring.Dropped());
+    return dump.Written();
+}
+
+static void PrintLatencies(const char* name, std::vector<uint32_t> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    printf("%-16s %8zu %8.2f %8.2f %8.2f %8.2f\n", name, n, samples[0] / 1000.0, samples[n / 2] / 1000.0,
+           samples[n * 99 / 100] / 1000.0, samples[n - 1] / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint8_t> capture;
+    if (argc > 1 && !LoadCapture(argv[1], capture))
+    {
+        printf("cannot read %s\n", argv[1]);
+        return 1;
+    }
+    if (argc <= 1)
+        capture = RecordSession();
+    double speed = argc > 2 ? atof(argv[2]) : 1;
+
+    std::vector<CaptureEvent> events;
+    if (!ParseCapture(capture, events))
+        printf("capture is truncated or not a capture, replaying %zu complete records\n", events.size());
+
+    LoopbackStream line;
+    Device device(line);
+    ReplayReport report = ReplayCapture(capture, events, line, device.executor, speed);
+
+    printf("\n== Replay of %zu records at speed %g\n", events.size(), speed);
+    printf("captured span %.1f ms, replayed in %.1f ms, %zu frames\n", report.capturedUs / 1000.0,
+           report.replayedUs / 1000.0, report.frames);
+    printf("%-16s %8s %8s %8s %8s %8s\n", "command", "frames", "min us", "p50 us", "p99 us", "max us");
+    for (const auto& entry : report.latencyNs)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "%u", entry.first);
+        PrintLatencies(name, entry.second);
+    }
+    if (!report.batchLatencyNs.empty())
+        PrintLatencies("batches", report.batchLatencyNs);
+
+    if (report.capturedSentBytes == 0)
+        printf("the capture holds no responses to compare with\n");
+    else if (report.firstDifference == SIZE_MAX)
+        printf("responses identical to the capture (%zu bytes)\n", report.sentBytes);
+    else
+        printf("responses differ from the capture at byte %zu (%zu bytes sent, %zu captured)\n",
+               report.firstDifference, report.sentBytes, report.capturedSentBytes);
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "BufferedStream.h"
+#include "CobsFraming.h"
+#include "CommandClient.h"
+#include "FdStream.h"
+#include "NewLineFraming.h"
+#include "ASCIISerializers.h"
+#include "BinarySerializers.h"
+
+// End-to-end throughput and latency of CommandClient against a CommandExecutor running on its
+// own thread, connected by a socketpair. The client keeps a window of requests outstanding and
+// sends a new one for every response; requests leave in frames of up to `batch` requests.
+// Usage: client_benchmark
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int MeasureMs = 300;
+constexpr size_t FrameSize = 4096;
+
+static CommandResultCodes Echo(ObjectStream& objStream) {
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100))) {
+        return SerializeError;
+    }
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static const CommandLookupItem commands[] = {
+    {1, Echo},
+};
+
+/// @brief Wire format under test: serializer, framing and frame delimiter.
+struct Format {
+    const char* name;
+    Serializer serializer;
+    FramingFactory framing;
+    uint8_t delimiter;
+};
+
+/// @brief Runs an executor on one end of a socketpair until `running` is cleared.
+static void ServeLoop(int fd, Format& format, std::atomic<bool>& running) {
+    FdStream transport(fd, true);
+    BufferedStream<256, FrameSize> stream(transport);
+    StaticCommandList list(commands, 1);
+    CommandExecutor executor(stream, list, format.framing, format.serializer);
+    uint8_t frameBuffer[FrameSize];
+    executor.EnableNonBlocking(frameBuffer, sizeof(frameBuffer), format.delimiter);
+    while (running) {
+        executor.Tick(Timeout::Milliseconds(5));
+    }
+}
+
+/// @brief Returns the given percentile of sorted latencies in microseconds.
+static double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+/// @brief Measures one window and batch size, with callbacks or with futures.
+static void Measure(Format& format, size_t window, size_t batch, bool futures) {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    std::atomic<bool> running{true};
+    std::thread server(ServeLoop, fds[1], std::ref(format), std::ref(running));
+
+    FdStream transport(fds[0], true);
+    BufferedStream<FrameSize> stream(transport);
+    CommandClient client(stream, format.framing, format.serializer, format.delimiter, batch, FrameSize);
+
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+    uint64_t failures = 0;
+    int value = 0;
+    const Timeout callTimeout = Timeout::Milliseconds(1000);
+
+    auto start = Clock::now();
+    auto end = start + std::chrono::milliseconds(MeasureMs);
+    if (futures) {
+        // Issue a window of futures, then wait for all of them
+        std::vector<std::future<Reply<int>>> replies;
+        std::vector<Clock::time_point> sent;
+        while (Clock::now() < end) {
+            replies.clear();
+            sent.clear();
+            for (size_t i = 0; i < window; ++i) {
+                sent.push_back(Clock::now());
+                replies.push_back(client.Call<int>(1, callTimeout, value++));
+            }
+            for (size_t i = 0; i < window; ++i) {
+                client.Wait(replies[i], callTimeout);
+                Reply<int> reply = replies[i].get();
+                failures += reply.result != Ok;
+                latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent[i]).count());
+            }
+        }
+    } else {
+        // Keep the window full, sending a new request for every completion
+        size_t outstanding = 0;
+        std::function<void()> sendOne = [&] {
+            Clock::time_point sentAt = Clock::now();
+            int* echoed = new int(0);
+            int argument = value++;
+            client.Send(1,
+                        [argument](ObjectStream& objStream) {
+                            return objStream.Write(argument, Timeout::Milliseconds(100));
+                        },
+                        [echoed](ObjectStream& objStream) {
+                            return objStream.Read(*echoed, Timeout::Milliseconds(0));
+                        },
+                        [&, sentAt, echoed, argument](CommandResultCodes result) {
+                            failures += result != Ok || *echoed != argument;
+                            delete echoed;
+                            latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sentAt).count());
+                            outstanding--;
+                        },
+                        callTimeout);
+            outstanding++;
+        };
+        while (Clock::now() < end) {
+            while (outstanding < window) {
+                sendOne();
+            }
+            client.Poll(Timeout::Milliseconds(1));
+        }
+        while (outstanding > 0) {
+            client.Poll(Timeout::Milliseconds(100)); // Ends at the latest when the calls time out
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    running = false;
+    server.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-8s %-9s %6zu %6zu %14.0f %10.1f %10.1f %9llu\n", format.name, futures ? "futures" : "callbacks",
+           window, batch, latencies.size() / seconds, Percentile(latencies, 0.5), Percentile(latencies, 0.99),
+           static_cast<unsigned long long>(failures));
+}
+
+int main() {
+    Format formats[] = {
+        {"ascii", SerializerFactory::CreateAsciiSerializer(),
+         [](IStream& stream, std::function<void(Framing&)> body) {
+             NewLineFraming newLine(stream);
+             body(newLine);
+         },
+         '\n'},
+        {"binary", SerializerFactory::CreateBinarySerializer(),
+         [](IStream& stream, std::function<void(Framing&)> body) {
+             uint8_t rx[FrameSize], tx[FrameSize];
+             CobsFraming cobs(stream, rx, sizeof(rx), tx, sizeof(tx));
+             body(cobs);
+         },
+         0},
+    };
+
+    struct Shape {
+        size_t window;
+        size_t batch;
+    } shapes[] = {{1, 1}, {8, 1}, {8, 8}, {64, 1}, {64, 16}, {64, 64}};
+
+    printf("%-8s %-9s %6s %6s %14s %10s %10s %9s\n", "format", "api", "window", "batch", "commands/s",
+           "p50 us", "p99 us", "failures");
+    for (Format& format : formats) {
+        for (bool futures : {false, true}) {
+            for (const Shape& shape : shapes) {
+                Measure(format, shape.window, shape.batch, futures);
+                fflush(stdout);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <vector>
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "LzCodec.h"
+#include "ObjectStream.h"
+#include "ASCIISerializers.h"
+#include "BinarySerializers.h"
+
+// Compression ratio and CPU cost of LzCodec on typical protocol frames, and the line time it
+// saves at 115200 baud. Compression pays off while the CPU time per frame on the target stays
+// below the line time saved; host CPU times are shown, a small microcontroller is much slower.
+
+constexpr double BaudRate = 115200;
+constexpr double ByteUs = 10e6 / BaudRate; // 8N1: 10 bits per byte
+
+/// @brief Builds a frame payload by writing items through a serializer.
+template <typename Body>
+static std::vector<uint8_t> MakeFrame(Serializer& serializer, Body&& body) {
+    LoopbackStream stream;
+    ObjectStream objStream(stream, serializer);
+    body(stream, objStream);
+    return stream.Written();
+}
+
+static void Measure(const char* name, const std::vector<uint8_t>& frame) {
+    std::vector<uint8_t> coded;
+    LzEncode(frame.data(), frame.size(), [&](const uint8_t* data, size_t size) {
+        coded.insert(coded.end(), data, data + size);
+    });
+
+    uint8_t decoded[1024];
+    LzDecoder check(decoded, sizeof(decoded));
+    check.Feed(coded.data(), coded.size());
+    if (!check.Complete() || check.Length() != frame.size() || memcmp(decoded, frame.data(), frame.size()) != 0) {
+        printf("%s: round trip failed\n", name);
+        return;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s encode", name);
+    BenchmarkResult encode = RunBenchmark(label, [&] {
+        size_t count = 0;
+        DoNotOptimize(LzEncode(frame.data(), frame.size(), [&](const uint8_t* data, size_t size) {
+            count += size;
+        }));
+        DoNotOptimize(count);
+    }, 100);
+    snprintf(label, sizeof(label), "%s decode", name);
+    BenchmarkResult decode = RunBenchmark(label, [&] {
+        LzDecoder decoder(decoded, sizeof(decoded));
+        decoder.Feed(coded.data(), coded.size());
+        DoNotOptimize(decoder.Length());
+    }, 100);
+
+    printf("  -> %zu -> %zu bytes (%.2fx), line time saved %.0f us, host CPU %.2f us\n\n", frame.size(),
+           coded.size(), static_cast<double>(frame.size()) / coded.size(),
+           (static_cast<double>(frame.size()) - coded.size()) * ByteUs, (encode.nsPerOp + decode.nsPerOp) / 1000);
+}
+
+int main() {
+    Serializer ascii = SerializerFactory::CreateAsciiSerializer();
+    Serializer binary = SerializerFactory::CreateBinarySerializer();
+    const Timeout timeout = Timeout::Milliseconds(100);
+
+    uint16_t samples[16];
+    for (size_t i = 0; i < 16; ++i) {
+        samples[i] = static_cast<uint16_t>(512 + (i * 7) % 9);
+    }
+
+    struct Frame {
+        const char* name;
+        std::vector<uint8_t> bytes;
+    } frames[] = {
+        {"ascii Ok", MakeFrame(ascii, [&](IStream& s, ObjectStream& o) {
+             ascii.Serialize(s, CommandResult::OK(), timeout);
+         })},
+        {"ascii 4 readings + Ok", MakeFrame(ascii, [&](IStream& s, ObjectStream& o) {
+             for (int reading : {512, 1023, 7, 330}) {
+                 o.Write(reading, timeout);
+             }
+             ascii.Serialize(s, CommandResult::OK(), timeout);
+         })},
+        {"ascii 8 batched echo responses", MakeFrame(ascii, [&](IStream& s, ObjectStream& o) {
+             for (int i = 0; i < 8; ++i) {
+                 o.Write(40 + i, timeout);
+                 ascii.Serialize(s, CommandResult::OK(), timeout);
+             }
+         })},
+        {"ascii 8 batched requests", MakeFrame(ascii, [&](IStream& s, ObjectStream& o) {
+             for (int i = 0; i < 8; ++i) {
+                 ascii.Serialize(s, CommandRequest{1, 0}, timeout);
+                 o.Write(40 + i, timeout);
+             }
+         })},
+        {"ascii telemetry chunk, 16 samples", MakeFrame(ascii, [&](IStream& s, ObjectStream& o) {
+             o.WriteArray(samples, 16, timeout);
+             ascii.Serialize(s, CommandResult{Streaming, 0}, timeout);
+         })},
+        {"binary telemetry chunk, 16 samples", MakeFrame(binary, [&](IStream& s, ObjectStream& o) {
+             o.WriteArray(samples, 16, timeout);
+             binary.Serialize(s, CommandResult{Streaming, 0}, timeout);
+         })},
+    };
+
+    for (const Frame& frame : frames) {
+        PrintHeader(frame.name);
+        Measure(frame.name, frame.bytes);
+    }
+    return 0;
+}
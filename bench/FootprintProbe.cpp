@@ -0,0 +1,38 @@
+#include "LoopbackStream.h"
+#include "NewLineFraming.h"
+#include "ASCIISerializers.h"
+#include "CommandList.h"
+#include "CommandExecutor.h"
+#include "StaticCommandExecutor.h"
+
+// Minimal program holding one executor, built once per variant so the size of the two binaries
+// can be compared: footprint_probe_static defines PROBE_STATIC, footprint_probe_dynamic does not.
+
+static CommandResultCodes NopCommand(ObjectStream& objStream)
+{
+    return Ok;
+}
+
+static constexpr CommandLookupItem probeCommands[] = {
+    {0, NopCommand},
+};
+static constexpr auto commandList = MakeCommandList(probeCommands);
+
+int main()
+{
+    LoopbackStream stream;
+    stream.Feed("0\n");
+#ifdef PROBE_STATIC
+    AsciiSerializer serializer;
+    auto executor = MakeCommandExecutor<NewLineFraming>(stream, commandList, serializer);
+#else
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    CommandExecutor executor(stream, commandList, framingFactory, serializer);
+#endif
+    executor.Tick(Timeout::Milliseconds(100));
+    return stream.Written().empty();
+}
@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <new>
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "NewLineFraming.h"
+#include "CobsFraming.h"
+#include "ASCIISerializers.h"
+#include "BinarySerializers.h"
+#include "CommandList.h"
+#include "CommandExecutor.h"
+#include "StaticCommandExecutor.h"
+
+// RAM and heap footprint of the executors: object sizes, heap allocations per Tick and Tick time
+// of CommandExecutor against StaticCommandExecutor. Exits with an error if the static executor
+// touches the heap. Flash cost is reported by the footprint_probe targets at build time.
+
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    allocations++;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+static CommandResultCodes EchoCommand(ObjectStream& objStream)
+{
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100)))
+        return SerializeError;
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static constexpr CommandLookupItem footprintCommands[] = {
+    {0, EchoCommand},
+    {1, EchoCommand},
+};
+static constexpr auto commandList = MakeCommandList(footprintCommands);
+
+static uint8_t rxFrame[64];
+static uint8_t txFrame[64];
+
+/// @brief Runs `ticks` echo requests through an executor and returns the heap allocations they made.
+template <typename Executor>
+static size_t CountAllocations(Executor& executor, LoopbackStream& stream, size_t ticks)
+{
+    size_t before = allocations;
+    for (size_t i = 0; i < ticks; ++i) {
+        stream.Rewind();
+        stream.ClearWritten();
+        executor.Tick(Timeout::Milliseconds(100));
+    }
+    return allocations - before;
+}
+
+template <typename Executor>
+static size_t Report(const char* name, Executor& executor, LoopbackStream& stream)
+{
+    // Grow the stream's vectors once, so only allocations made by the executor are counted
+    CountAllocations(executor, stream, 1);
+    size_t heap = CountAllocations(executor, stream, 1000);
+    printf("%-48s %8zu %14.3f\n", name, sizeof(Executor), heap / 1000.0);
+    return heap;
+}
+
+int main()
+{
+    Serializer ascii = SerializerFactory::CreateAsciiSerializer();
+    Serializer binary = SerializerFactory::CreateBinarySerializer();
+    AsciiSerializer staticAscii;
+    BinarySerializer staticBinary;
+
+    FramingFactory newLineFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    FramingFactory cobsFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        CobsFraming framing(stream, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        callback(framing);
+    };
+
+    LoopbackStream asciiStream;
+    asciiStream.Feed("1 123456\n");
+    LoopbackStream binaryStream;
+    {
+        // Encode one binary echo request over COBS
+        LoopbackStream encoded;
+        CobsFraming framing(encoded, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        binary.Serialize(framing, CommandRequest{1, 7}, Timeout::Milliseconds(100));
+        binary.Serialize(framing, 123456, Timeout::Milliseconds(100));
+        framing.Flush(Timeout::Milliseconds(100));
+        binaryStream.Feed(encoded.Written().data(), encoded.Written().size());
+    }
+
+    CommandExecutor asciiExecutor(asciiStream, commandList, newLineFactory, ascii);
+    CommandExecutor binaryExecutor(binaryStream, commandList, cobsFactory, binary);
+    auto staticAsciiExecutor = MakeCommandExecutor<NewLineFraming>(asciiStream, commandList, staticAscii);
+    auto staticBinaryExecutor = MakeCommandExecutor<CobsFraming>(binaryStream, commandList, staticBinary,
+                                                                 rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+
+    static_assert(sizeof(staticAsciiExecutor) < sizeof(CommandExecutor),
+                  "The static executor must not carry a type-erased factory");
+
+    printf("== Executor footprint (host, %zu-bit)\n", sizeof(void*) * 8);
+    printf("%-48s %8s %14s\n", "executor", "bytes", "allocs/Tick");
+    Report("CommandExecutor ascii/newline", asciiExecutor, asciiStream);
+    Report("CommandExecutor binary/cobs", binaryExecutor, binaryStream);
+    size_t staticHeap = Report("StaticCommandExecutor ascii/newline", staticAsciiExecutor, asciiStream);
+    staticHeap += Report("StaticCommandExecutor binary/cobs", staticBinaryExecutor, binaryStream);
+
+    PrintHeader("Tick time");
+    RunBenchmark("CommandExecutor::Tick (ascii echo)", [&] {
+        asciiStream.Rewind();
+        asciiStream.ClearWritten();
+        asciiExecutor.Tick(Timeout::Milliseconds(100));
+    });
+    RunBenchmark("StaticCommandExecutor::Tick (ascii echo)", [&] {
+        asciiStream.Rewind();
+        asciiStream.ClearWritten();
+        staticAsciiExecutor.Tick(Timeout::Milliseconds(100));
+    });
+    RunBenchmark("CommandExecutor::Tick (binary echo over COBS)", [&] {
+        binaryStream.Rewind();
+        binaryStream.ClearWritten();
+        binaryExecutor.Tick(Timeout::Milliseconds(100));
+    });
+    RunBenchmark("StaticCommandExecutor::Tick (binary echo over COBS)", [&] {
+        binaryStream.Rewind();
+        binaryStream.ClearWritten();
+        staticBinaryExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    if (staticHeap) {
+        printf("\nFAIL: StaticCommandExecutor allocated %zu times\n", staticHeap);
+        return 1;
+    }
+    return 0;
+}
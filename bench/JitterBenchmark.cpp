@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "Benchmark.h"
+#include "NewLineFraming.h"
+#include "Serializer.h"
+#include "ObjectStream.h"
+#include "CommandList.h"
+#include "CommandExecutor.h"
+
+// Worst-case loop() jitter under trickled input: how long a single executor Tick can stall
+// the caller's loop while requests arrive at UART speed, blocking against non-blocking mode.
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief An `IStream` whose input becomes readable over time, as if it arrived over a UART.
+/// Frames start every `framePeriod` and their bytes arrive one every `byteTime`.
+/// Reads never block; responses are counted by their terminating newline.
+class TrickleStream : public IStream {
+    std::vector<uint8_t> input;    ///< All bytes that will arrive.
+    std::vector<double> arrival;   ///< Arrival time of each byte in microseconds after `start`.
+    size_t position = 0;           ///< Bytes read so far.
+    Clock::time_point start = Clock::now();
+
+public:
+    size_t responses = 0;          ///< Newlines written so far, one per response frame.
+
+    TrickleStream(const char* frame, size_t frames, double framePeriodUs, double byteTimeUs) {
+        size_t length = strlen(frame);
+        for (size_t i = 0; i < frames; ++i) {
+            for (size_t j = 0; j < length; ++j) {
+                input.push_back(static_cast<uint8_t>(frame[j]));
+                arrival.push_back(i * framePeriodUs + (j + 1) * byteTimeUs);
+            }
+        }
+    }
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        double now = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        size_t count = 0;
+        while (count < size && position < input.size() && arrival[position] <= now) {
+            static_cast<uint8_t*>(data)[count++] = input[position++];
+        }
+        return count;
+    }
+
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        responses += std::count(bytes, bytes + size, '\n');
+        return size;
+    }
+
+    virtual void Flush(const Timeout& timeout) override {}
+};
+
+static CommandResultCodes EchoCommand(ObjectStream& objStream)
+{
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100)))
+        return SerializeError;
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static const CommandLookupItem jitterCommands[] = {
+    {1, EchoCommand},
+};
+
+static void RunLoop(const char* name, bool nonBlocking, uint64_t tickTimeoutMs)
+{
+    // 200 echo requests at 115200 baud (87 us per byte), one every 2 ms
+    constexpr size_t frames = 200;
+    TrickleStream stream("1 12345\n", frames, 2000.0, 87.0);
+    StaticCommandList commandList(jitterCommands, 1);
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    CommandExecutor executor(stream, commandList, framingFactory, serializer);
+    uint8_t frameBuffer[64];
+    if (nonBlocking) {
+        executor.EnableNonBlocking(frameBuffer, sizeof(frameBuffer), '\n');
+    }
+
+    std::vector<double> ticks;
+    ticks.reserve(1 << 22);
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (stream.responses < frames && Clock::now() < deadline) {
+        auto start = Clock::now();
+        executor.Tick(Timeout::Milliseconds(tickTimeoutMs));
+        ticks.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    std::sort(ticks.begin(), ticks.end());
+    double sum = 0;
+    for (double tick : ticks) {
+        sum += tick;
+    }
+    printf("%-32s %10zu %10zu %10.1f %10.1f %10.1f\n", name, stream.responses, ticks.size(),
+           sum / ticks.size(), ticks[ticks.size() * 99 / 100], ticks.back());
+}
+
+int main()
+{
+    printf("\n== loop() jitter, 200 echo requests trickled at 115200 baud\n");
+    printf("%-32s %10s %10s %10s %10s %10s\n", "mode", "responses", "ticks", "mean us", "p99 us", "max us");
+    RunLoop("blocking Tick(1000 ms)", false, 1000);
+    RunLoop("blocking Tick(1 ms)", false, 1);
+    RunLoop("non-blocking Tick(0)", true, 0);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+#include "CommandList.h"
+
+// Lookup cost against table size: the linear StaticCommandList compared with the
+// compile-time ConstexprCommandList for contiguous (dense) and spread out (sparse) codes.
+
+static CommandResultCodes NopCommand(ObjectStream& objStream)
+{
+    return Ok;
+}
+
+/// @brief A lookup table of N commands with codes `i * Stride`, generated at compile time in reverse order.
+template <size_t N, uint32_t Stride>
+struct GeneratedTable {
+    CommandLookupItem items[N];
+
+    constexpr GeneratedTable() : items{} {
+        for (size_t i = 0; i < N; ++i) {
+            items[i] = CommandLookupItem{static_cast<uint32_t>((N - 1 - i) * Stride), NopCommand};
+        }
+    }
+};
+
+template <size_t N, uint32_t Stride>
+static void BenchList(const CommandList& commandList, const char* kind)
+{
+    // Look up every code in a scrambled order so the branch predictor cannot learn the position
+    constexpr size_t keyCount = 1024;
+    static uint32_t keys[keyCount];
+    for (size_t i = 0; i < keyCount; ++i) {
+        keys[i] = static_cast<uint32_t>((i * 7919) % N) * Stride;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%-28s %5zu entries", kind, N);
+    size_t next = 0;
+    RunBenchmark(name, [&] {
+        DoNotOptimize(commandList.Lookup(keys[next]));
+        next = (next + 1) & (keyCount - 1);
+    });
+}
+
+template <size_t N>
+static void BenchSize()
+{
+    static constexpr GeneratedTable<N, 1> denseTable;
+    static constexpr GeneratedTable<N, 7> sparseTable;
+    static constexpr auto denseList = MakeCommandList(denseTable.items);
+    static constexpr auto sparseList = MakeCommandList(sparseTable.items);
+    StaticCommandList linearList(sparseTable.items, N);
+
+    BenchList<N, 7>(linearList, "StaticCommandList");
+    BenchList<N, 1>(denseList, "ConstexprCommandList dense");
+    BenchList<N, 7>(sparseList, "ConstexprCommandList sparse");
+}
+
+int main()
+{
+    PrintHeader("CommandList::Lookup");
+    BenchSize<10>();
+    BenchSize<100>();
+    BenchSize<1000>();
+    return 0;
+}
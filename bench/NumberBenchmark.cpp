@@ -0,0 +1,163 @@
+#include <cfloat>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "ASCIISerializers.h"
+#include "NumberText.h"
+
+// The ASCII number codecs in NumberText.h against the itoa/atoi and C library paths they replace,
+// on their own and through the ASCII serializer.
+
+// A spread of magnitudes, so the digit count and branch pattern change from call to call
+static const int intValues[8] = {7, -42, 1234, -98765, 1000000, -2147483647, 31337, 123456789};
+static const int64_t int64Values[8] = {7, -42, 1234567890123LL, -9000000000000000000LL,
+                                       1LL << 40, 123456789, -1, 4611686018427387904LL};
+static const float floatValues[8] = {0.5f, 3.14159f, -273.15f, 1e-3f, 6.02214e23f, 100.0f, -0.1f, 12345.678f};
+
+// Every float written by FormatFloat must parse back to the same value, the range limits included
+static bool CheckFloatRoundTrip()
+{
+    const float limits[] = {FLT_MAX, -FLT_MAX, FLT_MIN, -FLT_MIN, FLT_TRUE_MIN, 0.0f};
+    bool ok = true;
+    for (float expected : limits)
+    {
+        char buffer[NumberTextMaxLength + 1];
+        size_t length = FormatFloat(expected, buffer);
+        buffer[length] = '\0';
+        float value = 0;
+        if (!ParseFloat(buffer, length, value) || value != expected)
+        {
+            printf("FAIL: %s does not parse back to itself\n", buffer);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+template <typename Body>
+static void BenchCycle(const char* name, Body&& body)
+{
+    size_t next = 0;
+    RunBenchmark(name, [&] {
+        body(next);
+        next = (next + 1) & 7;
+    });
+}
+
+int main()
+{
+    char text[8][32];
+
+    PrintHeader("int formatting");
+    BenchCycle("itoa", [&](size_t i) {
+        char buffer[16];
+        itoa(intValues[i], buffer, 10);
+        DoNotOptimize(buffer[0]);
+    });
+    BenchCycle("FormatSigned", [&](size_t i) {
+        char buffer[NumberTextMaxLength];
+        DoNotOptimize(FormatSigned(intValues[i], buffer + sizeof(buffer)));
+    });
+
+    PrintHeader("int parsing");
+    for (size_t i = 0; i < 8; ++i) {
+        snprintf(text[i], sizeof(text[i]), "%d", intValues[i]);
+    }
+    BenchCycle("atoi", [&](size_t i) {
+        DoNotOptimize(atoi(text[i]));
+    });
+    BenchCycle("ParseInteger<int> (range checked)", [&](size_t i) {
+        int value = 0;
+        DoNotOptimize(ParseInteger(text[i], strlen(text[i]), value));
+        DoNotOptimize(value);
+    });
+
+    PrintHeader("int64 formatting and parsing");
+    BenchCycle("snprintf %lld", [&](size_t i) {
+        char buffer[32];
+        DoNotOptimize(snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(int64Values[i])));
+    });
+    BenchCycle("FormatSigned (int64)", [&](size_t i) {
+        char buffer[NumberTextMaxLength];
+        DoNotOptimize(FormatSigned(int64Values[i], buffer + sizeof(buffer)));
+    });
+    for (size_t i = 0; i < 8; ++i) {
+        snprintf(text[i], sizeof(text[i]), "%lld", static_cast<long long>(int64Values[i]));
+    }
+    BenchCycle("strtoll", [&](size_t i) {
+        DoNotOptimize(strtoll(text[i], nullptr, 10));
+    });
+    BenchCycle("ParseInteger<int64_t>", [&](size_t i) {
+        int64_t value = 0;
+        DoNotOptimize(ParseInteger(text[i], strlen(text[i]), value));
+        DoNotOptimize(value);
+    });
+
+    PrintHeader("float formatting and parsing");
+    BenchCycle("snprintf %.9g", [&](size_t i) {
+        char buffer[32];
+        DoNotOptimize(snprintf(buffer, sizeof(buffer), "%.9g", floatValues[i]));
+    });
+    BenchCycle("FormatFloat (shortest round trip)", [&](size_t i) {
+        char buffer[NumberTextMaxLength];
+        DoNotOptimize(FormatFloat(floatValues[i], buffer));
+    });
+    for (size_t i = 0; i < 8; ++i) {
+        text[i][FormatFloat(floatValues[i], text[i])] = '\0';
+    }
+    BenchCycle("strtof", [&](size_t i) {
+        DoNotOptimize(strtof(text[i], nullptr));
+    });
+    BenchCycle("ParseFloat", [&](size_t i) {
+        float value = 0;
+        DoNotOptimize(ParseFloat(text[i], strlen(text[i]), value));
+        DoNotOptimize(value);
+    });
+
+    PrintHeader("hex");
+    BenchCycle("snprintf %llx", [&](size_t i) {
+        char buffer[32];
+        DoNotOptimize(snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(int64Values[i])));
+    });
+    BenchCycle("FormatHex", [&](size_t i) {
+        char buffer[NumberTextMaxLength];
+        DoNotOptimize(FormatHex(static_cast<uint64_t>(int64Values[i]), buffer + sizeof(buffer)));
+    });
+    for (size_t i = 0; i < 8; ++i) {
+        snprintf(text[i], sizeof(text[i]), "0x%llx", static_cast<unsigned long long>(int64Values[i]));
+    }
+    BenchCycle("strtoull base 16", [&](size_t i) {
+        DoNotOptimize(strtoull(text[i], nullptr, 16));
+    });
+    BenchCycle("ParseHex", [&](size_t i) {
+        uint64_t value = 0;
+        DoNotOptimize(ParseHex(text[i], strlen(text[i]), value));
+        DoNotOptimize(value);
+    });
+
+    PrintHeader("ASCII serializer round trip");
+    AsciiSerializer serializer;
+    LoopbackStream stream;
+    BenchCycle("Serialize+Deserialize<int>", [&](size_t i) {
+        stream.ClearWritten();
+        serializer.Serialize(stream, intValues[i], Timeout::Milliseconds(100));
+        stream.Loop();
+        int value = 0;
+        DoNotOptimize(serializer.Deserialize(stream, value, Timeout::Milliseconds(100)));
+    });
+    BenchCycle("Serialize+Deserialize<int64_t>", [&](size_t i) {
+        stream.ClearWritten();
+        serializer.Serialize(stream, int64Values[i], Timeout::Milliseconds(100));
+        stream.Loop();
+        int64_t value = 0;
+        DoNotOptimize(serializer.Deserialize(stream, value, Timeout::Milliseconds(100)));
+    });
+    BenchCycle("Serialize+Deserialize<float>", [&](size_t i) {
+        stream.ClearWritten();
+        serializer.Serialize(stream, floatValues[i], Timeout::Milliseconds(100));
+        stream.Loop();
+        float value = 0;
+        DoNotOptimize(serializer.Deserialize(stream, value, Timeout::Milliseconds(100)));
+    });
+    return CheckFloatRoundTrip() ? 0 : 1;
+}
@@ -0,0 +1,579 @@
+#include <string>
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "BufferedStream.h"
+#include "NewLineFraming.h"
+#include "CobsFraming.h"
+#include "Serializer.h"
+#include "BinarySerializers.h"
+#include "ObjectStream.h"
+#include "CommandList.h"
+#include "CommandExecutor.h"
+#include "CommandClient.h"
+#include "TypedCommand.h"
+
+// Per-layer benchmarks of the command pipeline: framing, serialization, command lookup
+// and complete executor round trips over an in-memory stream.
+
+static CommandResultCodes NopCommand(ObjectStream& objStream)
+{
+    return Ok;
+}
+
+static CommandResultCodes EchoCommand(ObjectStream& objStream)
+{
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100)))
+        return SerializeError;
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static CommandResultCodes ReadingsCommand(ObjectStream& objStream)
+{
+    const int readings[] = {512, 1023, 7, 330};
+    for (int reading : readings)
+        objStream.Write(reading, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static CommandResultCodes AddCommand(ObjectStream& objStream)
+{
+    int a, b;
+    if (!objStream.Read(a, Timeout::Milliseconds(100)) || !objStream.Read(b, Timeout::Milliseconds(100)))
+        return SerializeError;
+    return objStream.Write(a + b, Timeout::Milliseconds(100)) ? Ok : SerializeError;
+}
+
+static int Add(int a, int b)
+{
+    return a + b;
+}
+
+static int Checksum(const char* name, ConstSpan<int32_t> values)
+{
+    int sum = 0;
+    for (const char* c = name; *c; ++c)
+        sum += *c;
+    for (size_t i = 0; i < values.size; ++i)
+        sum += values.data[i];
+    return sum;
+}
+
+static CommandResultCodes ChecksumCommand(ObjectStream& objStream)
+{
+    char name[32];
+    int32_t values[16];
+    TextBuffer nameBuffer{name, sizeof(name) - 1, 0};
+    SpanBuffer<int32_t> valueBuffer{values, 16, 0};
+    if (!objStream.Read(nameBuffer, Timeout::Milliseconds(100)) || !objStream.Read(valueBuffer, Timeout::Milliseconds(100)))
+        return SerializeError;
+    name[nameBuffer.size] = '\0';
+    return objStream.Write(Checksum(name, ConstSpan<int32_t>{values, valueBuffer.size}), Timeout::Milliseconds(100)) ? Ok : SerializeError;
+}
+
+static CommandResultCodes CalibrationCommand(ObjectStream& objStream)
+{
+    static const float table[16] = {0.98f, 1.01f, 1.00f, 0.97f, 1.03f, 0.99f, 1.02f, 1.00f,
+                                    0.96f, 1.04f, 1.01f, 0.98f, 1.00f, 1.02f, 0.99f, 1.01f};
+    objStream.WriteArray(table, 16, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static uint32_t calibrationEpoch = 0;
+
+static const CommandLookupItem benchCommands[] = {
+    {0, NopCommand},  {1, EchoCommand}, {2, ReadingsCommand},  {3, NopCommand},
+    {4, NopCommand},  {5, NopCommand},  {6, NopCommand},  {7, NopCommand},
+    {8, NopCommand},  {9, NopCommand},  {10, NopCommand}, {11, NopCommand},
+    {12, NopCommand}, {13, NopCommand}, {14, NopCommand}, {15, NopCommand},
+};
+
+static void BenchTimeout()
+{
+    PrintHeader("Timeout");
+    Timeout timeout = Timeout::Milliseconds(1000);
+
+    RunBenchmark("Timeout::Expired", [&] {
+        DoNotOptimize(timeout.Expired());
+    });
+
+    TimeoutCheck<> check(timeout);
+    RunBenchmark("TimeoutCheck<16>::Expired", [&] {
+        DoNotOptimize(check.Expired());
+    });
+
+    Timeout zero = Timeout::Milliseconds(0);
+    RunBenchmark("Timeout::Expired (zero timeout)", [&] {
+        DoNotOptimize(zero.Expired());
+    });
+}
+
+static void BenchFraming()
+{
+    PrintHeader("NewLineFraming");
+    LoopbackStream stream;
+    stream.Feed("0123456789 0123456789 0123456789\n");
+
+    RunBenchmark("NewLineFraming::Read (32 byte frame)", [&] {
+        char buffer[64];
+        stream.Rewind();
+        NewLineFraming framing(stream);
+        DoNotOptimize(framing.Read(buffer, sizeof(buffer), Timeout::Milliseconds(100)));
+    });
+
+    LoopbackStream unbuffered;
+    BufferedStream<64> buffered(unbuffered);
+    unbuffered.Feed("0123456789 0123456789 0123456789\n");
+    RunBenchmark("NewLineFraming::Read (32 byte frame, buffered)", [&] {
+        char buffer[64];
+        unbuffered.Rewind();
+        NewLineFraming framing(buffered);
+        DoNotOptimize(framing.Read(buffer, sizeof(buffer), Timeout::Milliseconds(100)));
+    });
+
+    RunBenchmark("NewLineFraming::Write+Flush (32 byte frame)", [&] {
+        stream.ClearWritten();
+        NewLineFraming framing(stream);
+        Timeout timeout = Timeout::Milliseconds(100);
+        framing.Write("0123456789 0123456789 0123456789", 32, timeout);
+        framing.Flush(timeout);
+    });
+}
+
+static void BenchSerializer()
+{
+    PrintHeader("Serializer (ASCII)");
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    LoopbackStream stream;
+
+    RunBenchmark("Serializer::Serialize<int>", [&] {
+        stream.ClearWritten();
+        serializer.Serialize(stream, 123456, Timeout::Milliseconds(100));
+    });
+
+    RunBenchmark("Serializer::Serialize<CommandResult>", [&] {
+        stream.ClearWritten();
+        serializer.Serialize(stream, CommandResult::OK(), Timeout::Milliseconds(100));
+    });
+
+    stream.Feed("123456 ");
+    RunBenchmark("Serializer::Deserialize<int>", [&] {
+        int value;
+        stream.Rewind();
+        serializer.Deserialize(stream, value, Timeout::Milliseconds(100));
+        DoNotOptimize(value);
+    });
+
+    LoopbackStream unbuffered;
+    BufferedStream<64> buffered(unbuffered);
+    unbuffered.Feed("123456 ");
+    RunBenchmark("Serializer::Deserialize<int> (buffered)", [&] {
+        int value;
+        unbuffered.Rewind();
+        serializer.Deserialize(buffered, value, Timeout::Milliseconds(100));
+        DoNotOptimize(value);
+    });
+
+    LoopbackStream requestStream;
+    requestStream.Feed("7 ");
+    RunBenchmark("Serializer::Deserialize<CommandRequest>", [&] {
+        CommandRequest request;
+        requestStream.Rewind();
+        serializer.Deserialize(requestStream, request, Timeout::Milliseconds(100));
+        DoNotOptimize(request);
+    });
+}
+
+static void BenchLookup()
+{
+    PrintHeader("StaticCommandList");
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+
+    RunBenchmark("StaticCommandList::Lookup (first of 16)", [&] {
+        DoNotOptimize(commandList.Lookup(0));
+    });
+
+    RunBenchmark("StaticCommandList::Lookup (last of 16)", [&] {
+        DoNotOptimize(commandList.Lookup(15));
+    });
+
+    RunBenchmark("StaticCommandList::Lookup (missing)", [&] {
+        DoNotOptimize(commandList.Lookup(1000));
+    });
+}
+
+static void BenchExecutor()
+{
+    PrintHeader("CommandExecutor");
+    LoopbackStream stream;
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    CommandExecutor executor(stream, commandList, framingFactory, serializer);
+
+    stream.Feed("0\n");
+    RunBenchmark("CommandExecutor::Tick (no arguments)", [&] {
+        stream.Rewind();
+        stream.ClearWritten();
+        executor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream echoStream;
+    CommandExecutor echoExecutor(echoStream, commandList, framingFactory, serializer);
+    echoStream.Feed("1 123456\n");
+    RunBenchmark("CommandExecutor::Tick (echo one int)", [&] {
+        echoStream.Rewind();
+        echoStream.ClearWritten();
+        echoExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream unbuffered;
+    BufferedStream<64> buffered(unbuffered);
+    CommandExecutor bufferedExecutor(buffered, commandList, framingFactory, serializer);
+    unbuffered.Feed("1 123456\n");
+    RunBenchmark("CommandExecutor::Tick (echo one int, buffered)", [&] {
+        unbuffered.Rewind();
+        unbuffered.ClearWritten();
+        bufferedExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream missingStream;
+    CommandExecutor missingExecutor(missingStream, commandList, framingFactory, serializer);
+    missingStream.Feed("99\n");
+    RunBenchmark("CommandExecutor::Tick (command not found)", [&] {
+        missingStream.Rewind();
+        missingStream.ClearWritten();
+        missingExecutor.Tick(Timeout::Milliseconds(100));
+    });
+}
+
+static void BenchResponseCache()
+{
+    PrintHeader("ResponseCache");
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    static const CommandLookupItem cachedCommands[] = {
+        {16, CalibrationCommand},
+        {17, CalibrationCommand, nullptr, &calibrationEpoch},
+    };
+    StaticCommandList commandList(cachedCommands, 2);
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    StaticResponseCache<4, 128> cache;
+
+    LoopbackStream plain;
+    CommandExecutor plainExecutor(plain, commandList, framingFactory, serializer);
+    plain.Feed("16\n");
+    RunBenchmark("CommandExecutor::Tick (16 floats, handler)", [&] {
+        plain.Rewind();
+        plain.ClearWritten();
+        plainExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream cached;
+    CommandExecutor cachedExecutor(cached, commandList, framingFactory, serializer);
+    cachedExecutor.EnableCache(cache);
+    cached.Feed("17\n");
+    RunBenchmark("CommandExecutor::Tick (16 floats, cached)", [&] {
+        cached.Rewind();
+        cached.ClearWritten();
+        cachedExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    RunBenchmark("CommandExecutor::Tick (16 floats, epoch bumped)", [&] {
+        calibrationEpoch++;
+        cached.Rewind();
+        cached.ClearWritten();
+        cachedExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    printf("%-48s %12u / %u\n", "cache hits / misses", cache.Hits(), cache.Misses());
+}
+
+static void BenchTypedCommand()
+{
+    PrintHeader("Typed commands");
+    static const CommandLookupItem addCommands[] = {
+        {20, AddCommand},
+        Command<21, Add>(),
+    };
+    StaticCommandList commandList(addCommands, 2);
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+
+    for (const char* request : {"20 1200 34\n", "21 1200 34\n"}) {
+        LoopbackStream stream;
+        Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+        CommandExecutor executor(stream, commandList, framingFactory, serializer);
+        stream.Feed(request);
+        RunBenchmark(request[1] == '0' ? "CommandExecutor::Tick (add, hand-written)" : "CommandExecutor::Tick (add, Command<>)", [&] {
+            stream.Rewind();
+            stream.ClearWritten();
+            executor.Tick(Timeout::Milliseconds(100));
+        });
+    }
+}
+
+static void BenchArena()
+{
+    PrintHeader("Arena arguments");
+    static const CommandLookupItem checksumCommands[] = {
+        {30, ChecksumCommand},
+        Command<31, Checksum>(),
+    };
+    StaticCommandList commandList(checksumCommands, 2);
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    StaticArena<128> arena;
+
+    for (const char* request : {"30 \"motor-left\" 8 10 20 30 40 50 60 70 80\n", "31 \"motor-left\" 8 10 20 30 40 50 60 70 80\n"}) {
+        LoopbackStream stream;
+        Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+        CommandExecutor executor(stream, commandList, framingFactory, serializer);
+        executor.EnableArena(arena);
+        stream.Feed(request);
+        RunBenchmark(request[1] == '0' ? "CommandExecutor::Tick (text + array, stack)" : "CommandExecutor::Tick (text + array, arena)", [&] {
+            stream.Rewind();
+            stream.ClearWritten();
+            executor.Tick(Timeout::Milliseconds(100));
+        });
+    }
+    printf("%-48s %12zu / %zu\n", "arena high-water mark / capacity", arena.HighWaterMark(), arena.Capacity());
+}
+
+static void BenchCobsFraming()
+{
+    PrintHeader("CobsFraming");
+    static uint8_t rxFrame[128];
+    static uint8_t txFrame[128];
+    const char payload[] = "0123456789 0123456789 0123456789";
+
+    // Encode one valid frame and a copy with a flipped bit
+    LoopbackStream encoded;
+    {
+        CobsFraming framing(encoded, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        framing.Write(payload, 32, Timeout::Milliseconds(100));
+        framing.Flush(Timeout::Milliseconds(100));
+    }
+    std::vector<uint8_t> frame = encoded.Written();
+    std::vector<uint8_t> corrupted = frame;
+    corrupted[5] ^= 0x04;
+
+    LoopbackStream unbuffered;
+    BufferedStream<64> buffered(unbuffered);
+    unbuffered.Feed(frame.data(), frame.size());
+    RunBenchmark("CobsFraming::Read (32 byte frame, buffered)", [&] {
+        char buffer[64];
+        unbuffered.Rewind();
+        CobsFraming framing(buffered, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        DoNotOptimize(framing.Read(buffer, sizeof(buffer), Timeout::Milliseconds(100)));
+    });
+
+    LoopbackStream dropStream;
+    BufferedStream<64> dropBuffered(dropStream);
+    dropStream.Feed(corrupted.data(), corrupted.size());
+    dropStream.Feed(frame.data(), frame.size());
+    RunBenchmark("CobsFraming::Read (corrupt frame dropped first)", [&] {
+        char buffer[64];
+        dropStream.Rewind();
+        CobsFraming framing(dropBuffered, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        DoNotOptimize(framing.Read(buffer, sizeof(buffer), Timeout::Milliseconds(100)));
+    });
+
+    LoopbackStream writeStream;
+    RunBenchmark("CobsFraming::Write+Flush (32 byte frame)", [&] {
+        writeStream.ClearWritten();
+        CobsFraming framing(writeStream, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        Timeout timeout = Timeout::Milliseconds(100);
+        framing.Write(payload, 32, timeout);
+        framing.Flush(timeout);
+    });
+
+    // Binary echo round trip
+    Serializer serializer = SerializerFactory::CreateBinarySerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        CobsFraming framing(stream, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        callback(framing);
+    };
+    LoopbackStream request;
+    {
+        CobsFraming framing(request, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        ObjectStream objStream(framing, serializer);
+        objStream.Write(CommandRequest{1}, Timeout::Milliseconds(100));
+        objStream.Write(123456, Timeout::Milliseconds(100));
+        framing.Flush(Timeout::Milliseconds(100));
+    }
+    LoopbackStream link;
+    BufferedStream<64> bufferedLink(link);
+    link.Feed(request.Written().data(), request.Written().size());
+    CommandExecutor executor(bufferedLink, commandList, framingFactory, serializer);
+    RunBenchmark("CommandExecutor::Tick (binary echo over COBS)", [&] {
+        link.Rewind();
+        link.ClearWritten();
+        executor.Tick(Timeout::Milliseconds(100));
+    });
+}
+
+static void BenchBatching()
+{
+    PrintHeader("Batched requests (binary over COBS)");
+    static uint8_t rxFrame[512];
+    static uint8_t txFrame[512];
+    Serializer serializer = SerializerFactory::CreateBinarySerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        CobsFraming framing(stream, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+        callback(framing);
+    };
+
+    const double roundTripSeconds = 0.002; // USB-serial adapters add about 1 ms each way
+    for (uint32_t batch : {1u, 8u, 32u}) {
+        LoopbackStream request;
+        {
+            CobsFraming framing(request, rxFrame, sizeof(rxFrame), txFrame, sizeof(txFrame));
+            ObjectStream objStream(framing, serializer);
+            for (uint32_t id = 0; id < batch; ++id) {
+                objStream.Write(CommandRequest{1, id}, Timeout::Milliseconds(100));
+                objStream.Write(123456, Timeout::Milliseconds(100));
+            }
+            framing.Flush(Timeout::Milliseconds(100));
+        }
+
+        LoopbackStream link;
+        BufferedStream<64> bufferedLink(link);
+        link.Feed(request.Written().data(), request.Written().size());
+        CommandExecutor executor(bufferedLink, commandList, framingFactory, serializer);
+
+        char name[64];
+        snprintf(name, sizeof(name), "CommandExecutor::Tick (%u echo requests)", batch);
+        BenchmarkResult result = RunBenchmark(name, [&] {
+            link.Rewind();
+            link.ClearWritten();
+            executor.Tick(Timeout::Milliseconds(100));
+        });
+
+        double secondsPerFrame = roundTripSeconds + result.nsPerOp * 1e-9;
+        printf("%-48s %12.0f commands/sec at 2 ms round trip\n", "", batch / secondsPerFrame);
+    }
+}
+
+// A request that fails may leave its arguments unread; the executor must not run them as requests
+static bool CheckFailedRequestEndsBatch()
+{
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+
+    LoopbackStream stream;
+    CommandExecutor executor(stream, commandList, framingFactory, serializer);
+    stream.Feed("99 1 5\n1 6\n");
+    executor.Tick(Timeout::Milliseconds(100));
+    executor.Tick(Timeout::Milliseconds(100));
+    std::string written(stream.Written().begin(), stream.Written().end());
+    if (written != "CommandNotFound \n6 Ok \n")
+    {
+        printf("\nFAIL: unknown command followed by a command code answered \"%s\"\n", written.c_str());
+        return false;
+    }
+    return true;
+}
+
+// The client must not hand the responses after a failed request to the requests of the aborted batch
+static bool CheckClientAbortedBatch()
+{
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+
+    LoopbackStream device;
+    LoopbackStream host;
+    CommandExecutor executor(device, commandList, framingFactory, serializer);
+    CommandClient client(host, framingFactory, serializer, '\n');
+    auto unknown = client.Call<>(99, Timeout::Milliseconds(1000));
+    auto aborted = client.Call<int>(1, Timeout::Milliseconds(1000), 7);
+    client.Flush(Timeout::Milliseconds(100));
+    auto echo = client.Call<int>(1, Timeout::Milliseconds(1000), 8);
+    client.Flush(Timeout::Milliseconds(100));
+
+    device.Feed(host.Written().data(), host.Written().size());
+    executor.Tick(Timeout::Milliseconds(100));
+    executor.Tick(Timeout::Milliseconds(100));
+    host.Feed(device.Written().data(), device.Written().size());
+    client.Poll(Timeout::Milliseconds(0));
+
+    bool ready = client.Wait(unknown, Timeout::Milliseconds(0)) && client.Wait(aborted, Timeout::Milliseconds(0)) &&
+                 client.Wait(echo, Timeout::Milliseconds(0));
+    Reply<int> echoReply = ready ? echo.get() : Reply<int>{};
+    if (!ready || unknown.get().result != CommandNotFound || aborted.get().result != BatchAborted ||
+        echoReply.result != Ok || std::get<0>(echoReply.values) != 8)
+    {
+        printf("\nFAIL: the client matched a response to a request of an aborted batch\n");
+        return false;
+    }
+    return true;
+}
+
+static void BenchWriteCalls()
+{
+    PrintHeader("Write coalescing");
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    StaticCommandList commandList(benchCommands, sizeof(benchCommands) / sizeof(benchCommands[0]));
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+
+    LoopbackStream direct;
+    CommandExecutor directExecutor(direct, commandList, framingFactory, serializer);
+    direct.Feed("2\n");
+    RunBenchmark("CommandExecutor::Tick (4 ints, direct writes)", [&] {
+        direct.Rewind();
+        direct.ClearWritten();
+        directExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream unbuffered;
+    BufferedStream<64> buffered(unbuffered);
+    CommandExecutor bufferedExecutor(buffered, commandList, framingFactory, serializer);
+    unbuffered.Feed("2\n");
+    RunBenchmark("CommandExecutor::Tick (4 ints, coalesced)", [&] {
+        unbuffered.Rewind();
+        unbuffered.ClearWritten();
+        bufferedExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+    printf("%-48s %12zu\n", "base stream writes per response (direct)", direct.WriteCalls());
+    printf("%-48s %12zu\n", "base stream writes per response (coalesced)", unbuffered.WriteCalls());
+}
+
+int main()
+{
+    BenchTimeout();
+    BenchFraming();
+    BenchSerializer();
+    BenchLookup();
+    BenchExecutor();
+    BenchWriteCalls();
+    BenchResponseCache();
+    BenchTypedCommand();
+    BenchArena();
+    BenchCobsFraming();
+    BenchBatching();
+    return CheckFailedRequestEndsBatch() && CheckClientAbortedBatch() ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "ASCIISerializers.h"
+#include "BinarySerializers.h"
+#include "ByteSpan.h"
+#include "CommandStructures.h"
+#include "ObjectStream.h"
+
+// Compares the ASCII and binary serializers: bytes on the wire and encode/decode time.
+
+// Writes a buffer of ADC samples the way a command would: one Write per element, or one WriteArray
+template <typename S>
+static void BenchSamples(const char* format, S serializer, const uint16_t* samples, size_t count)
+{
+    char name[64];
+    LoopbackStream stream;
+    ObjectStream objStream(stream, serializer);
+
+    snprintf(name, sizeof(name), "%s Write<int> x%zu", format, count);
+    auto perElement = RunBenchmark(name, [&] {
+        stream.ClearWritten();
+        for (size_t i = 0; i < count; ++i) {
+            objStream.Write(static_cast<int>(samples[i]), Timeout::Milliseconds(100));
+        }
+    });
+    size_t perElementCalls = stream.WriteCalls();
+
+    snprintf(name, sizeof(name), "%s WriteArray<uint16_t> %zu", format, count);
+    auto array = RunBenchmark(name, [&] {
+        stream.ClearWritten();
+        objStream.WriteArray(samples, count, Timeout::Milliseconds(100));
+    });
+    printf("  -> %.1fx faster, %zu stream writes instead of %zu\n",
+           perElement.nsPerOp / array.nsPerOp, stream.WriteCalls(), perElementCalls);
+
+    stream.Loop();
+    snprintf(name, sizeof(name), "%s ReadArray<uint16_t> %zu", format, count);
+    RunBenchmark(name, [&] {
+        static uint16_t received[4096];
+        size_t size;
+        stream.Rewind();
+        objStream.ReadArray(received, 4096, size, Timeout::Milliseconds(100));
+        DoNotOptimize(size);
+    });
+}
+
+template <typename T>
+static size_t EncodedSize(const Serializer& serializer, const T& item)
+{
+    LoopbackStream stream;
+    serializer.Serialize(stream, item, Timeout::Milliseconds(100));
+    return stream.Written().size();
+}
+
+template <typename T>
+static void PrintSizes(const char* name, const Serializer& ascii, const Serializer& binary, const T& item)
+{
+    printf("%-36s %8zu %8zu\n", name, EncodedSize(ascii, item), EncodedSize(binary, item));
+}
+
+template <typename S, typename T>
+static void BenchType(const char* format, const char* type, const S& serializer, const T& item)
+{
+    char name[64];
+    LoopbackStream stream;
+
+    snprintf(name, sizeof(name), "%s Serialize<%s>", format, type);
+    RunBenchmark(name, [&] {
+        stream.ClearWritten();
+        serializer.Serialize(stream, item, Timeout::Milliseconds(100));
+    });
+
+    stream.Loop();
+    snprintf(name, sizeof(name), "%s Deserialize<%s>", format, type);
+    RunBenchmark(name, [&] {
+        T value;
+        stream.Rewind();
+        serializer.Deserialize(stream, value, Timeout::Milliseconds(100));
+        DoNotOptimize(value);
+    });
+}
+
+int main()
+{
+    Serializer ascii = SerializerFactory::CreateAsciiSerializer();
+    Serializer binary = SerializerFactory::CreateBinarySerializer();
+
+    printf("== Bytes on wire\n");
+    printf("%-36s %8s %8s\n", "item", "ascii", "binary");
+    PrintSizes("int 7", ascii, binary, 7);
+    PrintSizes("int -1000", ascii, binary, -1000);
+    PrintSizes("int 123456789", ascii, binary, 123456789);
+    PrintSizes("CommandRequest{42}", ascii, binary, CommandRequest{42});
+    PrintSizes("CommandResult{Ok}", ascii, binary, CommandResult::OK());
+    PrintSizes("CommandResult{CommandNotFound}", ascii, binary, CommandResult::Error(CommandNotFound));
+
+    // A typical response: four sensor readings followed by the result
+    size_t asciiResponse = 0, binaryResponse = 0;
+    const int readings[] = {512, 1023, 7, 330};
+    for (int reading : readings) {
+        asciiResponse += EncodedSize(ascii, reading);
+        binaryResponse += EncodedSize(binary, reading);
+    }
+    asciiResponse += EncodedSize(ascii, CommandResult::OK());
+    binaryResponse += EncodedSize(binary, CommandResult::OK());
+    printf("%-36s %8zu %8zu\n", "response: 4 ints + Ok", asciiResponse, binaryResponse);
+
+    PrintHeader("Encode/decode time");
+    BenchType("ascii ", "int 123456789", ascii, 123456789);
+    BenchType("binary", "int 123456789", binary, 123456789);
+    BenchType("ascii ", "int 7", ascii, 7);
+    BenchType("binary", "int 7", binary, 7);
+    BenchType("ascii ", "CommandResult", ascii, CommandResult::OK());
+    BenchType("binary", "CommandResult", binary, CommandResult::OK());
+    BenchType("binary", "float", binary, 3.14159f);
+
+    // Compile-time dispatch against the runtime table
+    BenchType("static ascii ", "int 123456789", AsciiSerializer(), 123456789);
+    BenchType("static binary", "int 123456789", BinarySerializer(), 123456789);
+    BenchType("static binary", "CommandResult", BinarySerializer(), CommandResult::OK());
+
+    uint8_t blob[32] = {};
+    LoopbackStream blobStream;
+    RunBenchmark("binary Serialize<ConstByteSpan 32>", [&] {
+        blobStream.ClearWritten();
+        binary.Serialize(blobStream, ConstByteSpan{blob, sizeof(blob)}, Timeout::Milliseconds(100));
+    });
+    blobStream.Loop();
+    RunBenchmark("binary Deserialize<ByteBuffer 32>", [&] {
+        uint8_t storage[32];
+        ByteBuffer buffer{storage, sizeof(storage), 0};
+        blobStream.Rewind();
+        binary.Deserialize(blobStream, buffer, Timeout::Milliseconds(100));
+        DoNotOptimize(buffer.size);
+    });
+
+    // A sensor dump: 1000 12-bit ADC readings
+    PrintHeader("Sample buffer, 1000 x uint16_t");
+    uint16_t samples[1000];
+    for (size_t i = 0; i < 1000; ++i) {
+        samples[i] = static_cast<uint16_t>((i * 2654435761u >> 20) & 0xFFF);
+    }
+    BenchSamples("ascii ", AsciiSerializer(), samples, 1000);
+    BenchSamples("binary", BinarySerializer(), samples, 1000);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "CommandServer.h"
+#include "NewLineFraming.h"
+#include "ASCIISerializers.h"
+
+// Throughput of the multi-threaded CommandServer with 1 to N clients over loopback TCP.
+// Each client keeps a window of requests in flight and sends a new one for every response.
+// Usage: server_benchmark [max clients]
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int Window = 4;          // Requests each client keeps in flight
+constexpr int MeasureMs = 300;
+
+static CommandResultCodes Echo(ObjectStream& objStream) {
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100))) {
+        return SerializeError;
+    }
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+// Stands in for a handler doing real work, about a few microseconds of arithmetic
+static CommandResultCodes Work(ObjectStream& objStream) {
+    int rounds;
+    if (!objStream.Read(rounds, Timeout::Milliseconds(100))) {
+        return SerializeError;
+    }
+    uint32_t x = 2463534242u;
+    for (int i = 0; i < rounds; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    objStream.Write(static_cast<int>(x & 0x7FFF), Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static const CommandLookupItem commands[] = {
+    {1, Echo},
+    {2, Work},
+};
+
+static int Connect(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        perror("connect");
+        exit(1);
+    }
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return fd;
+}
+
+/// @brief Runs `clients` clients against a server with `workerCount` workers.
+/// @return Responses per second over all clients.
+static double Measure(const char* request, int clients, size_t workerCount) {
+    StaticCommandList list(commands, 2);
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    FramingFactory framing = [](IStream& stream, std::function<void(Framing&)> body) {
+        NewLineFraming newLine(stream);
+        body(newLine);
+    };
+    CommandServer<> server(list, serializer, framing, '\n', workerCount);
+
+    int listenFd = ListenTcp(0, true);
+    uint16_t port = ListeningPort(listenFd);
+    std::atomic<bool> accepting{true};
+    std::thread acceptor([&] {
+        while (accepting) {
+            int fd = AcceptConnection(listenFd, Timeout::Milliseconds(20));
+            if (fd >= 0) {
+                server.ServeFd(fd);
+            }
+        }
+    });
+
+    std::atomic<bool> running{true};
+    std::vector<uint64_t> responses(clients);
+    std::vector<std::thread> threads;
+    size_t requestLength = strlen(request);
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            FdStream stream(Connect(port), true);
+            for (int i = 0; i < Window; ++i) {
+                stream.Write(request, requestLength, Timeout::Milliseconds(1000));
+            }
+            uint8_t buffer[1024];
+            uint64_t received = 0;
+            while (running) {
+                size_t count = stream.Read(buffer, sizeof(buffer), Timeout::Milliseconds(50));
+                for (size_t i = 0; i < count; ++i) {
+                    if (buffer[i] == '\n') {
+                        received++;
+                        stream.Write(request, requestLength, Timeout::Milliseconds(1000));
+                    }
+                }
+            }
+            responses[c] = received;
+        });
+    }
+
+    auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(MeasureMs));
+    running = false;
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    accepting = false;
+    acceptor.join();
+    close(listenFd);
+    server.Stop();
+
+    uint64_t total = 0;
+    for (uint64_t count : responses) {
+        total += count;
+    }
+    return total / seconds;
+}
+
+int main(int argc, char** argv) {
+    int maxClients = argc > 1 ? atoi(argv[1]) : 16;
+    size_t cores = std::thread::hardware_concurrency();
+    std::vector<size_t> workerCounts = {1};
+    if (cores > 1) {
+        workerCounts.push_back(cores);
+    }
+
+    struct Load {
+        const char* name;
+        const char* request;
+    } loads[] = {
+        {"echo", "1 42\n"},
+        {"work (2000 rounds)", "2 2000\n"},
+    };
+
+    printf("%zu hardware threads, %d requests in flight per client\n", cores, Window);
+    for (const Load& load : loads) {
+        printf("\n== %s\n", load.name);
+        printf("%-10s", "clients");
+        for (size_t workers : workerCounts) {
+            printf("  %10zu worker%s", workers, workers == 1 ? " " : "s");
+        }
+        printf("\n");
+        for (int clients = 1; clients <= maxClients; clients *= 2) {
+            printf("%-10d", clients);
+            for (size_t workers : workerCounts) {
+                printf("  %11.0f req/s", Measure(load.request, clients, workers));
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
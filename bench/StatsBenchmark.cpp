@@ -0,0 +1,98 @@
+#include <chrono>
+#include "Benchmark.h"
+#include "LoopbackStream.h"
+#include "NewLineFraming.h"
+#include "Serializer.h"
+#include "ObjectStream.h"
+#include "CommandList.h"
+#include "CommandExecutor.h"
+
+// Cost of the COMMANDKIT_STATS instrumentation. This file is built twice, as stats_benchmark
+// with the statistics enabled and stats_benchmark_off without; compare the two reports.
+
+static CommandResultCodes EchoCommand(ObjectStream& objStream)
+{
+    int value;
+    if (!objStream.Read(value, Timeout::Milliseconds(100)))
+        return SerializeError;
+    objStream.Write(value, Timeout::Milliseconds(100));
+    return Ok;
+}
+
+static CommandResultCodes SlowCommand(ObjectStream& objStream)
+{
+    // Busy wait about 50 us, like a short sensor read
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+    return Ok;
+}
+
+static const CommandLookupItem statsCommands[] = {
+    {1, EchoCommand},
+    {2, SlowCommand},
+};
+
+int main()
+{
+    LoopbackStream stream;
+    Serializer serializer = SerializerFactory::CreateAsciiSerializer();
+    StaticCommandList commandList(statsCommands, 2);
+    FramingFactory framingFactory = [](IStream& stream, std::function<void(Framing&)> callback) {
+        NewLineFraming framing(stream);
+        callback(framing);
+    };
+    CommandExecutor executor(stream, commandList, framingFactory, serializer);
+
+    printf("COMMANDKIT_STATS=%d, sizeof(CommandExecutor) = %zu\n", COMMANDKIT_STATS, sizeof(CommandExecutor));
+
+    PrintHeader(COMMANDKIT_STATS ? "CommandExecutor with stats" : "CommandExecutor without stats");
+    stream.Feed("1 123456\n");
+    RunBenchmark("CommandExecutor::Tick (echo one int)", [&] {
+        stream.Rewind();
+        stream.ClearWritten();
+        executor.Tick(Timeout::Milliseconds(100));
+    });
+
+    LoopbackStream batchStream;
+    CommandExecutor batchExecutor(batchStream, commandList, framingFactory, serializer);
+    batchStream.Feed("1 1 1 2 1 3 1 4 1 5 1 6 1 7 1 8\n");
+    RunBenchmark("CommandExecutor::Tick (8 echo requests)", [&] {
+        batchStream.Rewind();
+        batchStream.ClearWritten();
+        batchExecutor.Tick(Timeout::Milliseconds(100));
+    });
+
+#if COMMANDKIT_STATS
+    // A mix of fast, slow and unknown commands, then the stats dump as a client would see it
+    LoopbackStream mixStream;
+    CommandExecutor mixExecutor(mixStream, commandList, framingFactory, serializer);
+    for (int i = 0; i < 1000; ++i) {
+        mixStream.Feed(i % 10 == 0 ? "2\n" : i % 25 == 1 ? "7\n" : "1 42\n");
+        mixExecutor.Tick(Timeout::Milliseconds(100));
+    }
+
+    printf("\n== Stats after 1000 mixed requests\n");
+    const CommandStats& stats = mixExecutor.Stats();
+    const char* stages[] = {"read", "lookup", "execute", "write", "flush"};
+    for (size_t i = 0; i < static_cast<size_t>(CommandStage::Count); ++i) {
+        printf("stage %-8s %8u us\n", stages[i], stats.StageMicros(static_cast<CommandStage>(i)));
+    }
+    for (const CommandStatsEntry& entry : stats) {
+        printf("cmd %-3u calls %5u errors %4u  us histogram:", entry.cmd, entry.calls, entry.errors);
+        for (size_t i = 0; i < StatsBuckets; ++i) {
+            if (entry.buckets[i]) {
+                printf(" <%u:%u", 1u << i, entry.buckets[i]);
+            }
+        }
+        printf("\n");
+    }
+
+    mixStream.ClearWritten();
+    mixStream.Feed("-255 1\n");
+    mixExecutor.Tick(Timeout::Milliseconds(100));
+    printf("BuiltinStats response: %.*s", static_cast<int>(mixStream.Written().size()),
+           reinterpret_cast<const char*>(mixStream.Written().data()));
+#endif
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+/// @file Arduino.h
+/// @brief Minimal stand-in for the Arduino core used by host (Linux) builds.
+/// Only the functions the CommandKit sources rely on are provided. Timing is based on
+/// `std::chrono::steady_clock`, measured from the first call into the shim.
+
+namespace ArduinoShim {
+    /// @brief Returns the time point all shim clocks are measured from.
+    inline std::chrono::steady_clock::time_point Epoch() {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return epoch;
+    }
+}
+
+/// @brief Milliseconds elapsed since the shim was first used, truncated like the Arduino counter.
+inline unsigned long millis() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - ArduinoShim::Epoch()).count());
+}
+
+/// @brief Microseconds elapsed since the shim was first used, truncated like the Arduino counter.
+inline unsigned long micros() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - ArduinoShim::Epoch()).count());
+}
+
+/// @brief Blocks the calling thread for the given number of milliseconds.
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/// @brief Converts an integer to text in the given base, matching the AVR/ESP `itoa` extension.
+/// @return The `str` pointer passed in.
+inline char* itoa(int value, char* str, int base) {
+    char* out = str;
+    unsigned int magnitude = static_cast<unsigned int>(value);
+    if (value < 0 && base == 10) {
+        *out++ = '-';
+        magnitude = 0u - magnitude;
+    }
+
+    char* digits = out;
+    do {
+        unsigned int digit = magnitude % base;
+        *out++ = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        magnitude /= base;
+    } while (magnitude);
+    *out = '\0';
+
+    // Digits were produced least significant first
+    for (char* end = out - 1; digits < end; ++digits, --end) {
+        char tmp = *digits;
+        *digits = *end;
+        *end = tmp;
+    }
+    return str;
+}
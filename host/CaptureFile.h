@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "CaptureStream.h"
+
+/// @brief An `ICaptureSink` writing records to a file as they happen, see `CaptureStream.h`.
+/// On the host a `CaptureStream` over an `FdStream` with this sink records a serial session of
+/// any length. The file is flushed on destruction; call `Flush` to inspect it while recording.
+class CaptureFile : public ICaptureSink {
+    FILE* file;            ///< The capture file, null if it could not be created.
+    uint32_t lastUs = 0;   ///< Time of the previous record.
+    bool empty = true;     ///< No record written yet.
+
+public:
+    /// @brief Creates the capture file, replacing an existing one, and writes `CaptureMagic`.
+    /// @param path The path of the file.
+    explicit CaptureFile(const char* path) : file(fopen(path, "wb")) {
+        if (file) {
+            fwrite(CaptureMagic, 1, sizeof(CaptureMagic), file);
+        }
+    }
+
+    ~CaptureFile() {
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+
+    /// @brief Returns true if the file was created.
+    bool IsOpen() const { return file != nullptr; }
+
+    virtual void Record(CaptureDirection direction, uint32_t timeUs, const uint8_t* data, size_t size) override {
+        if (!file) {
+            return;
+        }
+        uint8_t header[CaptureHeaderMax];
+        size_t headerSize = EncodeCaptureHeader(header, direction, empty ? 0 : timeUs - lastUs, size);
+        fwrite(header, 1, headerSize, file);
+        fwrite(data, 1, size, file);
+        lastUs = timeUs;
+        empty = false;
+    }
+
+    /// @brief Writes the records buffered by the C library to the file.
+    void Flush() {
+        if (file) {
+            fflush(file);
+        }
+    }
+};
+
+/// @brief One record of a loaded capture.
+struct CaptureEvent {
+    CaptureDirection direction; ///< Whether the device read or wrote the bytes.
+    uint64_t timeUs;            ///< Microseconds since the first record.
+    size_t offset;              ///< Position of the bytes in the capture.
+    size_t size;                ///< Number of bytes.
+};
+
+/// @brief Splits a capture into its records.
+/// @param capture The capture, as written by `CaptureFile` or `CaptureRing::Dump`.
+/// @param events Receives the records in order.
+/// @return False if the capture does not start with `CaptureMagic` or its last record is truncated;
+///         the complete records before it are still returned.
+inline bool ParseCapture(const std::vector<uint8_t>& capture, std::vector<CaptureEvent>& events) {
+    events.clear();
+    if (capture.size() < sizeof(CaptureMagic) || memcmp(capture.data(), CaptureMagic, sizeof(CaptureMagic)) != 0) {
+        return false;
+    }
+
+    uint64_t timeUs = 0;
+    size_t position = sizeof(CaptureMagic);
+    while (position < capture.size()) {
+        CaptureEvent event;
+        uint32_t deltaUs;
+        size_t headerSize = DecodeCaptureHeader(capture.data() + position, capture.size() - position,
+                                                event.direction, deltaUs, event.size);
+        if (headerSize == 0 || event.size > capture.size() - position - headerSize) {
+            return false;
+        }
+        timeUs += events.empty() ? 0 : deltaUs;
+        event.timeUs = timeUs;
+        event.offset = position + headerSize;
+        events.push_back(event);
+        position = event.offset + event.size;
+    }
+    return true;
+}
+
+/// @brief Reads a whole capture file.
+/// @return False if the file could not be read.
+inline bool LoadCapture(const char* path, std::vector<uint8_t>& capture) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    capture.clear();
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        capture.insert(capture.end(), chunk, chunk + count);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
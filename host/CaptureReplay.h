@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "CaptureFile.h"
+#include "CommandStats.h"
+#include "LoopbackStream.h"
+
+#if !COMMANDKIT_STATS
+#error "CaptureReplay.h attributes latencies with the executor statistics, build with COMMANDKIT_STATS=1"
+#endif
+
+/// @brief The outcome of `ReplayCapture`.
+struct ReplayReport {
+    std::map<uint32_t, std::vector<uint32_t>> latencyNs; ///< Per command code, the time of each frame holding only it.
+    std::vector<uint32_t> batchLatencyNs;  ///< The time of each frame holding several commands.
+    size_t frames = 0;                     ///< Frames that executed at least one command.
+    size_t sentBytes = 0;                  ///< Bytes the replayed executor sent.
+    size_t capturedSentBytes = 0;          ///< Bytes the device sent in the capture.
+    size_t firstDifference = SIZE_MAX;     ///< Offset of the first sent byte that differs from the capture, or SIZE_MAX.
+    uint64_t capturedUs = 0;               ///< Time spanned by the capture.
+    uint64_t replayedUs = 0;               ///< Time the replay took.
+};
+
+/// @brief Feeds the received bytes of a capture through an executor, paced like the capture.
+/// Bytes are fed as they were read on the device, in the same chunks, at their original time
+/// divided by `speed`; between them the executor is ticked like a sketch's `loop()` does. Each
+/// tick that executes a frame is timed: from the frame's complete arrival to its flushed response,
+/// the latency the device would add to a round trip. Frames are attributed to their command with
+/// the executor statistics, so the executor must be built with `COMMANDKIT_STATS`, and must be in
+/// non-blocking mode over `stream`, see `CommandExecutorCore::EnableNonBlocking`. What the
+/// executor sends is compared with what the device sent, which shows whether the host build of
+/// the commands reproduces the field unit's behaviour. A capture from a `CaptureRing` that dropped
+/// records may start in the middle of a frame, whose response then differs from the start.
+/// @param capture The capture, see `LoadCapture`.
+/// @param events Its records, see `ParseCapture`.
+/// @param stream The stream the executor serves; it should be empty.
+/// @param executor The executor, with the same command codes, framing and serializer as the device.
+/// @param speed How much faster than captured to feed the bytes; 0 feeds them as fast as they are served.
+/// @return The latencies and the comparison of the responses.
+template <typename Executor>
+ReplayReport ReplayCapture(const std::vector<uint8_t>& capture, const std::vector<CaptureEvent>& events,
+                           LoopbackStream& stream, Executor& executor, double speed) {
+    using Clock = std::chrono::steady_clock;
+    ReplayReport report;
+    std::vector<uint8_t> captured;
+
+    // One tick; returns true if it executed or answered a frame
+    auto tick = [&] {
+        CommandStats before = executor.Stats();
+        size_t written = stream.Written().size();
+        Clock::time_point start = Clock::now();
+        executor.Tick(Timeout::Milliseconds(0));
+        uint32_t elapsedNs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+        uint32_t calls = 0;
+        uint32_t cmd = 0;
+        const CommandStats& after = executor.Stats();
+        for (const CommandStatsEntry& entry : after) {
+            uint32_t previous = 0;
+            for (const CommandStatsEntry& old : before) {
+                previous = old.cmd == entry.cmd ? old.calls : previous;
+            }
+            if (entry.calls != previous) {
+                calls += entry.calls - previous;
+                cmd = entry.cmd;
+            }
+        }
+        if (calls == 1) {
+            report.latencyNs[cmd].push_back(elapsedNs);
+        } else if (calls > 1) {
+            report.batchLatencyNs.push_back(elapsedNs);
+        }
+        report.frames += calls > 0;
+        return calls > 0 || stream.Written().size() != written;
+    };
+
+    Clock::time_point replayStart = Clock::now();
+    for (const CaptureEvent& event : events) {
+        const uint8_t* bytes = capture.data() + event.offset;
+        if (event.direction == CaptureDirection::Sent) {
+            captured.insert(captured.end(), bytes, bytes + event.size);
+            continue;
+        }
+
+        if (speed > 0) {
+            auto due = replayStart + std::chrono::microseconds(static_cast<uint64_t>(event.timeUs / speed));
+            while (Clock::now() < due) {
+                tick();
+            }
+        }
+        stream.Feed(bytes, event.size);
+        while (tick()) {
+        }
+    }
+    while (tick()) {
+    }
+    report.replayedUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - replayStart).count());
+    if (!events.empty()) {
+        report.capturedUs = events.back().timeUs;
+    }
+
+    const std::vector<uint8_t>& sent = stream.Written();
+    report.sentBytes = sent.size();
+    report.capturedSentBytes = captured.size();
+    auto difference = std::mismatch(sent.begin(), sent.end(), captured.begin(), captured.end());
+    if (difference.first != sent.end() || difference.second != captured.end()) {
+        report.firstDifference = static_cast<size_t>(difference.first - sent.begin());
+    }
+    return report;
+}
@@ -0,0 +1,390 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "CommandExecutor.h"
+#include "FrameStream.h"
+#include "NullStream.h"
+#include "Scan.h"
+
+/// @brief The outcome of a `CommandClient::Call`: the result code and the command's outputs.
+/// The outputs are only meaningful if `result` is `Ok`.
+/// @tparam Outputs The types the command writes before its result.
+template <typename... Outputs>
+struct Reply {
+    CommandResultCodes result = GeneralError;
+    std::tuple<Outputs...> values;
+};
+
+/// @brief A host-side client for a `CommandExecutor`, built on the same framing and serializers.
+/// Requests are queued with `Send` or `Call` and leave in batches: several requests share one
+/// frame, sent when `BatchSize` requests are queued or on the next `Flush` or `Poll`. Any number
+/// of requests may be outstanding. `Poll` collects the response frames that have arrived, matches
+/// each response to its request and completes it, and fails requests whose timeout has expired
+/// with `TimedOut`.
+///
+/// Responses are matched by the id in their `ResponseHeader`. Formats without ids (ASCII) answer
+/// in order, so their responses are matched to the oldest outstanding request; a timed out request
+/// keeps its place until a later response arrives. With ids, frames that match no request, such as
+/// pushed job completions and stream chunks, are skipped. Without ids such a frame cannot be told
+/// from a response, so once a response reports a started job or stream (`Pending` or `Streaming`)
+/// the client stops matching: it sends nothing more, and every outstanding and later request fails
+/// with `GeneralError`. Use a format with ids for jobs and streams.
+///
+/// The executor answers each request frame with one response frame, and ends a batch at the first
+/// request that fails, see `CommandExecutorCore::ExecuteFrame`. So when a response frame ends, the
+/// requests of its request frame that it left unanswered are completed with `BatchAborted`.
+///
+/// A response carries no length, so its outputs are parsed by the request's reader. A response is
+/// accepted if the result after the outputs is followed by the end of the frame or by the header
+/// of another outstanding request. Otherwise the result is read again straight after the header,
+/// which is how an error from a command that wrote no outputs is recognised. With ids (binary)
+/// this check is reliable in practice but not proof against every payload; a response that fits
+/// neither reading completes with `SerializeError`, and so do the requests after it in its frame.
+///
+/// The client is not thread-safe; drive it from one thread.
+class CommandClient {
+public:
+    /// @brief Writes the arguments of a request.
+    using ArgsWriter = std::function<bool(ObjectStream&)>;
+    /// @brief Reads the outputs of a response, before its result.
+    using OutputsReader = std::function<bool(ObjectStream&)>;
+    /// @brief Called once with the result of a request.
+    using Completion = std::function<void(CommandResultCodes)>;
+
+private:
+    /// @brief A request waiting for its response.
+    struct PendingCall {
+        uint32_t id;            ///< Request id, sent to the executor.
+        Timeout deadline;       ///< When the request fails with `TimedOut`.
+        OutputsReader read;     ///< Parses the outputs, may be empty.
+        Completion done;        ///< Completes the request.
+        bool expired;           ///< Already completed with `TimedOut`, kept for in-order matching.
+        uint32_t frame;         ///< Number of the outgoing frame the request is sent in.
+    };
+
+    /// @brief A request queued for the next frame.
+    struct OutgoingRequest {
+        uint32_t cmd;
+        uint32_t id;
+        ArgsWriter args;
+    };
+
+    IStream& stream;                     ///< The transport to the executor.
+    FramingFactory framingFactory;       ///< Builds the framing of each outgoing and incoming frame.
+    Serializer& serializer;              ///< Must match the executor's format.
+    uint8_t frameDelimiter;              ///< Byte that ends a frame on the wire.
+    size_t batchSize;                    ///< Requests per outgoing frame.
+    NullStream nullStream;               ///< Output of incoming frames, which never write.
+
+    std::vector<OutgoingRequest> outbox; ///< Requests of the next outgoing frame.
+    std::list<PendingCall> pending;      ///< Outstanding requests, oldest first.
+    uint32_t lastId = 0;                 ///< The most recently issued request id.
+    uint32_t framesSent = 0;             ///< Outgoing frames sent so far, the number of the next one.
+    bool unmatchable = false;            ///< A response without id started a job or stream, see the class comment.
+
+    std::vector<uint8_t> rxBuffer;       ///< Collects incoming frames.
+    size_t rxLength = 0;                 ///< Bytes collected in `rxBuffer`.
+    size_t rxScanned = 0;                ///< Bytes of `rxBuffer` already searched for the delimiter.
+    bool discarding = false;             ///< Dropping the rest of a frame that did not fit `rxBuffer`.
+    std::vector<uint8_t> payload;        ///< The decoded payload of the frame being parsed.
+
+public:
+    /// @brief Write timeout for arguments written by `Call`.
+    static constexpr uint32_t ArgsTimeoutMs = 100;
+
+    /// @brief Constructs a client over a connected stream.
+    /// @param transport The stream to the executor.
+    /// @param framing The factory building the framing, the same kind as the executor's.
+    /// @param ser The serializer, the same format as the executor's.
+    /// @param delimiter The byte ending each frame on the wire: '\n' for `NewLineFraming`, 0 for `CobsFraming`.
+    /// @param batch The number of requests sent together in one frame, at least 1.
+    /// @param maxFrame The largest incoming frame in bytes; larger frames are dropped.
+    CommandClient(IStream& transport, FramingFactory framing, Serializer& ser, uint8_t delimiter,
+                  size_t batch = 16, size_t maxFrame = 4096)
+        : stream(transport), framingFactory(framing), serializer(ser), frameDelimiter(delimiter),
+          batchSize(batch ? batch : 1), rxBuffer(maxFrame) {}
+
+    /// @brief Queues a request.
+    /// @param cmd The command code.
+    /// @param args Writes the arguments; may be empty.
+    /// @param outputs Reads the outputs from the response; may be empty if the command writes none.
+    /// @param done Called from `Poll` with the result, or with `TimedOut`.
+    /// @param timeout The time allowed for the response, measured from now.
+    /// @return The request id.
+    uint32_t Send(uint32_t cmd, ArgsWriter args, OutputsReader outputs, Completion done, const Timeout& timeout) {
+        uint32_t id = ++lastId ? lastId : ++lastId;
+        outbox.push_back(OutgoingRequest{cmd, id, std::move(args)});
+        pending.push_back(PendingCall{id, timeout, std::move(outputs), std::move(done), false, framesSent});
+        if (outbox.size() >= batchSize) {
+            Flush(timeout);
+        }
+        return id;
+    }
+
+    /// @brief Queues a request and returns a future for its reply.
+    /// The future becomes ready in `Poll`; use `Wait` to poll until then.
+    /// @tparam Outputs The types the command writes, given explicitly: `Call<int, float>(...)`.
+    /// @param cmd The command code.
+    /// @param timeout The time allowed for the response, measured from now.
+    /// @param args The arguments, serialized in order.
+    template <typename... Outputs, typename... Args>
+    std::future<Reply<Outputs...>> Call(uint32_t cmd, const Timeout& timeout, const Args&... args) {
+        auto reply = std::make_shared<Reply<Outputs...>>();
+        auto promise = std::make_shared<std::promise<Reply<Outputs...>>>();
+        std::future<Reply<Outputs...>> future = promise->get_future();
+        Send(cmd,
+             [args...](ObjectStream& objStream) {
+                 return (objStream.Write(args, Timeout::Milliseconds(ArgsTimeoutMs)) && ...);
+             },
+             [reply](ObjectStream& objStream) {
+                 return std::apply([&objStream](Outputs&... values) {
+                     return (objStream.Read(values, Timeout::Milliseconds(0)) && ...);
+                 }, reply->values);
+             },
+             [reply, promise](CommandResultCodes result) {
+                 reply->result = result;
+                 promise->set_value(*reply);
+             },
+             timeout);
+        return future;
+    }
+
+    /// @brief Sends the queued requests in one frame.
+    /// @param timeout A `Timeout` object specifying the maximum time allowed for writing the frame.
+    void Flush(const Timeout& timeout) {
+        if (outbox.empty() || unmatchable) {
+            return;
+        }
+        framingFactory(stream, [this, &timeout](Framing& framing) {
+            ObjectStream objStream(framing, serializer);
+            for (OutgoingRequest& request : outbox) {
+                serializer.Serialize(framing, CommandRequest{request.cmd, request.id}, timeout);
+                if (request.args) {
+                    request.args(objStream);
+                }
+            }
+            framing.Flush(timeout);
+        });
+        outbox.clear();
+        framesSent++;
+    }
+
+    /// @brief Sends queued requests, then handles the responses that arrive within `timeout`.
+    /// Returns as soon as some bytes have arrived and been handled, or when the timeout expires.
+    /// @param timeout A `Timeout` object bounding the wait for responses.
+    /// @return The number of requests completed, including those that timed out.
+    size_t Poll(const Timeout& timeout) {
+        Flush(timeout);
+
+        size_t completed = 0;
+        if (rxLength < rxBuffer.size()) {
+            rxLength += stream.Read(rxBuffer.data() + rxLength, rxBuffer.size() - rxLength, timeout);
+        }
+
+        size_t start = 0;
+        while (const uint8_t* end = FindByte(rxBuffer.data() + rxScanned, rxLength - rxScanned, frameDelimiter)) {
+            size_t next = end - rxBuffer.data() + 1;
+            if (discarding) {
+                discarding = false; // Tail of an oversized frame
+            } else {
+                completed += HandleFrame(rxBuffer.data() + start, next - start);
+            }
+            start = next;
+            rxScanned = next;
+        }
+
+        // Keep the start of the next frame
+        memmove(rxBuffer.data(), rxBuffer.data() + start, rxLength - start);
+        rxLength -= start;
+        rxScanned = rxLength;
+        if (rxLength == rxBuffer.size()) {
+            // The frame does not fit, drop what we have and skip ahead to its delimiter
+            rxLength = 0;
+            rxScanned = 0;
+            discarding = true;
+        }
+
+        if (unmatchable) {
+            completed += FailCalls();
+        }
+        return completed + ExpireCalls();
+    }
+
+    /// @brief Polls until a future is ready or the timeout expires.
+    /// @return True if the future is ready.
+    template <typename T>
+    bool Wait(std::future<T>& future, const Timeout& timeout) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (timeout.Expired()) {
+                return false;
+            }
+            Poll(Timeout::Milliseconds(1));
+        }
+        return true;
+    }
+
+    /// @brief Returns the number of requests waiting for a response, not counting timed out ones.
+    size_t Outstanding() const {
+        size_t count = 0;
+        for (const PendingCall& call : pending) {
+            count += !call.expired;
+        }
+        return count;
+    }
+
+private:
+    /// @brief Decodes one frame and completes the requests answered in it.
+    /// @return The number of requests completed.
+    size_t HandleFrame(const uint8_t* frame, size_t size) {
+        // Decode the whole payload first, so a response can be parsed again from its start
+        payload.clear();
+        FrameStream frameStream(frame, size, nullStream);
+        framingFactory(frameStream, [this](Framing& framing) {
+            uint8_t chunk[256];
+            while (size_t count = framing.Read(chunk, sizeof(chunk), Timeout::Milliseconds(0))) {
+                payload.insert(payload.end(), chunk, chunk + count);
+            }
+        });
+
+        FrameStream in(payload.data(), payload.size(), nullStream);
+        ObjectStream objStream(in, serializer);
+        size_t completed = 0;
+        bool answered = false;       // Some response of the frame matched a request
+        uint32_t requestFrame = 0;   // The request frame this frame answers
+        CommandResultCodes unanswered = BatchAborted;
+        bool jobStarted = false;     // A response without id started a job or stream
+        while (Remaining(in) > 0) {
+            ResponseHeader header;
+            if (!serializer.Deserialize(in, header, Timeout::Milliseconds(0))) {
+                break;
+            }
+
+            auto call = Match(header.id);
+            if (call == pending.end()) {
+                break; // Not ours, and its outputs cannot be skipped without knowing their types
+            }
+
+            // The outputs come first, unless the command failed without writing any
+            size_t outputs = payload.size() - Remaining(in);
+            CommandResult result;
+            bool parsed = (!call->read || call->read(objStream)) &&
+                          serializer.Deserialize(in, result, Timeout::Milliseconds(0)) &&
+                          AtResponseBoundary(in, call);
+            if (!parsed) {
+                in.Reset(payload.data() + outputs, payload.size() - outputs);
+                parsed = serializer.Deserialize(in, result, Timeout::Milliseconds(0)) &&
+                         result.resultCode != Ok && AtResponseBoundary(in, call);
+                if (!parsed) {
+                    result.resultCode = SerializeError;
+                }
+            }
+
+            // Older requests still waiting in this position have lost their responses
+            for (auto it = pending.begin(); it != call;) {
+                it = it->expired ? pending.erase(it) : std::next(it);
+            }
+            answered = true;
+            requestFrame = call->frame;
+            jobStarted |= header.id == 0 && (result.resultCode == Pending || result.resultCode == Streaming);
+            if (!call->expired) {
+                call->done(result.resultCode);
+                completed++;
+            }
+            pending.erase(call);
+
+            if (!parsed) {
+                unanswered = SerializeError;
+                break; // The rest of the frame cannot be located
+            }
+        }
+
+        // The responses to a request frame all arrive in one frame; what it lacks was not executed
+        if (answered) {
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (it->frame != requestFrame) {
+                    ++it;
+                    continue;
+                }
+                if (!it->expired) {
+                    it->done(unanswered);
+                    completed++;
+                }
+                it = pending.erase(it);
+            }
+        }
+        unmatchable |= jobStarted;
+        return completed;
+    }
+
+    /// @brief Checks that a response parsed up to here ends where the next one starts.
+    /// True at the end of the frame or before a header of another outstanding request. The
+    /// position of `in` is kept.
+    bool AtResponseBoundary(FrameStream& in, std::list<PendingCall>::iterator call) {
+        size_t remaining = Remaining(in);
+        if (remaining == 0) {
+            return true;
+        }
+        size_t position = payload.size() - remaining;
+        ResponseHeader next;
+        bool valid = serializer.Deserialize(in, next, Timeout::Milliseconds(0)) &&
+                     (next.id == 0 || (next.id != call->id && Match(next.id) != pending.end()));
+        in.Reset(payload.data() + position, remaining);
+        return valid;
+    }
+
+    /// @brief Finds the outstanding request a response belongs to.
+    /// @param id The id in the response header; 0 for formats without ids.
+    std::list<PendingCall>::iterator Match(uint32_t id) {
+        if (id == 0) {
+            return unmatchable ? pending.end() : pending.begin();
+        }
+        for (auto it = pending.begin(); it != pending.end(); ++it) {
+            if (it->id == id) {
+                return it;
+            }
+        }
+        return pending.end();
+    }
+
+    /// @brief Completes every outstanding and queued request with `GeneralError`, once responses
+    /// can no longer be matched.
+    /// @return The number of requests completed.
+    size_t FailCalls() {
+        size_t failed = 0;
+        for (PendingCall& call : pending) {
+            if (!call.expired) {
+                call.done(GeneralError);
+                failed++;
+            }
+        }
+        pending.clear();
+        outbox.clear();
+        return failed;
+    }
+
+    /// @brief Completes requests whose timeout has expired with `TimedOut`.
+    /// @return The number of requests completed.
+    size_t ExpireCalls() {
+        size_t expired = 0;
+        for (PendingCall& call : pending) {
+            if (!call.expired && call.deadline.Expired()) {
+                call.expired = true;
+                call.done(TimedOut);
+                expired++;
+            }
+        }
+        return expired;
+    }
+
+    /// @brief Returns the unread bytes of an in-memory stream.
+    static size_t Remaining(IStream& in) {
+        const uint8_t* data;
+        return in.Peek(data, Timeout::Milliseconds(0));
+    }
+};
@@ -0,0 +1,308 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BufferedStream.h"
+#include "CommandExecutor.h"
+#include "FdStream.h"
+#include "FrameStream.h"
+#include "MpscQueue.h"
+#include "Scan.h"
+#include "SpscQueue.h"
+
+/// @brief A host-side server that serves one command list over many transports at once.
+/// Each transport, such as a serial port or an accepted socket, gets an I/O thread that reads
+/// bytes, cuts them into frames at the delimiter and hands complete frames to a pool of worker
+/// threads. The worker executes the frame with the usual `Framing`, `Serializer` and
+/// `CommandFunc` machinery and writes the response straight back to the transport.
+///
+/// Nothing on the frame path takes a lock or allocates. Every connection owns `Depth` frame
+/// slots. A filled slot goes to its worker through the worker's lock-free `MpscQueue`, which all
+/// I/O threads share. The worker returns it through the connection's `SpscQueue`. A connection
+/// whose slots are all in flight stops reading, which pushes back on the sender. Each connection
+/// is pinned to one worker, so its frames are answered in order.
+///
+/// Commands run concurrently on different workers; with more than one worker they must be
+/// thread-safe. Jobs and streams are not served. Workers and I/O threads are stopped by `Stop`
+/// or the destructor.
+/// @tparam FrameSize The largest frame in bytes, delimiter included. Larger frames are dropped without a response.
+/// @tparam Depth Frames a connection can have in flight, a power of two.
+template <size_t FrameSize = 512, size_t Depth = 8>
+class CommandServer {
+    static constexpr uint32_t IoPollMs = 20;          ///< How often idle I/O threads check for `Stop`.
+    static constexpr uint32_t WriteTimeoutMs = 1000;  ///< Time allowed for writing one response.
+
+    struct Connection;
+
+    /// @brief One received frame on its way from an I/O thread to a worker.
+    struct FrameSlot : MpscNode {
+        Connection* connection;   ///< The connection the frame arrived on.
+        size_t size;              ///< Bytes in `data`.
+        uint8_t data[FrameSize];  ///< The frame, including its delimiter.
+    };
+
+    /// @brief A worker thread and the queue of frames it executes.
+    struct Worker {
+        MpscQueue<FrameSlot> frames;          ///< Frames from the I/O threads of its connections.
+        std::atomic<bool> sleeping{false};    ///< Set while the worker waits on `wake`.
+        std::mutex mutex;                     ///< Guards the wait on `wake`.
+        std::condition_variable wake;         ///< Signalled when a frame is queued for a sleeping worker.
+        std::thread thread;
+    };
+
+    /// @brief A transport together with the executor and frame slots serving it.
+    struct Connection {
+        IStream& transport;                  ///< The stream frames arrive on and responses leave on.
+        std::unique_ptr<FdStream> owned;     ///< The transport if the server owns it, see `ServeFd`.
+        BufferedStream<1, FrameSize> output; ///< Collects a response so it leaves in one write.
+        FrameStream session;                 ///< Presents the frame being executed to the executor.
+        CommandExecutor executor;            ///< Only used by the connection's worker.
+        Worker& worker;                      ///< The worker executing this connection's frames.
+        FrameSlot slots[Depth];
+        SpscQueue<FrameSlot*, Depth> free;   ///< Slots returned by the worker, taken by the I/O thread.
+        std::thread io;
+        std::atomic<bool> finished{false};   ///< Set when the I/O thread has ended and every slot is back.
+
+        Connection(IStream& stream, std::unique_ptr<FdStream> own, const CommandList& list,
+                   const FramingFactory& framing, Serializer& serializer, Worker& assigned)
+            : transport(stream), owned(std::move(own)), output(stream), session(nullptr, 0, output),
+              executor(session, list, framing, serializer), worker(assigned) {
+            for (FrameSlot& slot : slots) {
+                slot.connection = this;
+                free.TryPush(&slot);
+            }
+        }
+    };
+
+    const CommandList& commandList;   ///< The commands served on every transport.
+    Serializer& serializer;           ///< Serializer for requests, responses and command arguments.
+    FramingFactory framingFactory;    ///< Builds the framing of each frame, on the worker's stack.
+    const uint8_t delimiter;          ///< Byte that ends a frame on the wire.
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<Connection>> connections; ///< Guarded by `connectionsMutex`.
+    std::mutex connectionsMutex;
+    size_t nextWorker = 0;                     ///< Round robin position for new connections.
+    std::atomic<bool> stopping{false};         ///< Tells I/O threads to end.
+    std::atomic<bool> workersStopping{false};  ///< Tells workers to end once their queues are empty.
+    std::atomic<uint64_t> framesServed{0};
+
+public:
+    /// @brief Constructs the server and starts its workers.
+    /// @param cmdList The command list served on every transport.
+    /// @param ser The serializer for requests, responses and command arguments.
+    /// @param framing The factory building the framing of each frame, e.g. a `NewLineFraming` or a
+    ///        `CobsFraming` with buffers on the stack. It is called concurrently from the workers.
+    /// @param frameDelimiter The byte ending each frame on the wire: '\n' for `NewLineFraming`, 0 for `CobsFraming`.
+    /// @param workerCount The number of worker threads, at least 1.
+    CommandServer(const CommandList& cmdList, Serializer& ser, FramingFactory framing,
+                  uint8_t frameDelimiter, size_t workerCount)
+        : commandList(cmdList), serializer(ser), framingFactory(framing), delimiter(frameDelimiter) {
+        for (size_t i = 0; i < (workerCount ? workerCount : 1); ++i) {
+            workers.push_back(std::unique_ptr<Worker>(new Worker()));
+            Worker& worker = *workers.back();
+            worker.thread = std::thread([this, &worker] { WorkerLoop(worker); });
+        }
+    }
+
+    ~CommandServer() {
+        Stop();
+    }
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    /// @brief Starts serving a transport owned by the caller, such as a serial port.
+    /// It is served until `Stop` and must stay valid until then.
+    void Serve(IStream& transport) {
+        AddConnection(transport, nullptr);
+    }
+
+    /// @brief Starts serving a file descriptor, typically an accepted socket, and takes ownership of it.
+    /// The connection ends and the descriptor is closed once the peer closes it.
+    void ServeFd(int fd) {
+        std::unique_ptr<FdStream> stream(new FdStream(fd, true));
+        IStream& transport = *stream;
+        AddConnection(transport, std::move(stream));
+    }
+
+    /// @brief Returns the number of frames executed so far.
+    uint64_t FramesServed() const {
+        return framesServed.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Stops all I/O threads, lets the workers finish the frames already received and stops them.
+    void Stop() {
+        stopping = true;
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        for (auto& connection : connections) {
+            if (connection->io.joinable()) {
+                connection->io.join();
+            }
+        }
+
+        workersStopping = true;
+        for (auto& worker : workers) {
+            {
+                std::lock_guard<std::mutex> wakeLock(worker->mutex);
+                worker->wake.notify_one();
+            }
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+        connections.clear();
+    }
+
+private:
+    /// @brief Creates a connection on the next worker and starts its I/O thread.
+    /// Connections whose peer has gone are cleaned up first.
+    void AddConnection(IStream& transport, std::unique_ptr<FdStream> owned) {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        if (stopping) {
+            return;
+        }
+
+        for (size_t i = 0; i < connections.size();) {
+            if (connections[i]->finished) {
+                connections[i]->io.join();
+                connections[i] = std::move(connections.back());
+                connections.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        Worker& worker = *workers[nextWorker++ % workers.size()];
+        connections.push_back(std::unique_ptr<Connection>(
+            new Connection(transport, std::move(owned), commandList, framingFactory, serializer, worker)));
+        Connection& connection = *connections.back();
+        connection.io = std::thread([this, &connection] { IoLoop(connection); });
+    }
+
+    /// @brief Reads the transport of a connection and dispatches each complete frame to its worker.
+    /// Bytes are read straight into a free frame slot; the start of the next frame, if it arrived
+    /// together with the end of this one, moves on to the next slot.
+    void IoLoop(Connection& connection) {
+        FrameSlot* slot = TakeSlot(connection);
+        size_t scanned = 0;       // Bytes of the slot already searched for the delimiter
+        bool discarding = false;  // Dropping the rest of a frame that did not fit a slot
+
+        while (slot && !stopping && !(connection.owned && connection.owned->Closed())) {
+            slot->size += connection.transport.Read(slot->data + slot->size, FrameSize - slot->size,
+                                                    Timeout::Milliseconds(IoPollMs));
+
+            const uint8_t* end;
+            while ((end = FindByte(slot->data + scanned, slot->size - scanned, delimiter))) {
+                size_t size = end - slot->data + 1;
+                if (discarding) {
+                    discarding = false; // Tail of an oversized frame
+                    memmove(slot->data, slot->data + size, slot->size - size);
+                    slot->size -= size;
+                    scanned = 0;
+                    continue;
+                }
+
+                FrameSlot* next = TakeSlot(connection);
+                if (!next) {
+                    break; // Stopping, the frame is dropped
+                }
+                next->size = slot->size - size;
+                memcpy(next->data, slot->data + size, next->size);
+                slot->size = size;
+                Dispatch(connection, slot);
+                slot = next;
+                scanned = 0;
+            }
+
+            scanned = slot->size;
+            if (slot->size == FrameSize) {
+                // The frame does not fit, drop what we have and skip ahead to its delimiter
+                slot->size = 0;
+                scanned = 0;
+                discarding = true;
+            }
+        }
+
+        // The connection may only go away once the worker has returned every slot
+        size_t held = slot ? 1 : 0;
+        while (connection.free.Size() + held < Depth) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        connection.finished = true;
+    }
+
+    /// @brief Takes a free frame slot of a connection, waiting while all of them are in flight.
+    /// @return The empty slot, or nullptr if the server is stopping.
+    FrameSlot* TakeSlot(Connection& connection) {
+        FrameSlot* slot;
+        while (!connection.free.TryPop(slot)) {
+            if (stopping) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+        slot->size = 0;
+        return slot;
+    }
+
+    /// @brief Queues a complete frame for the connection's worker and wakes the worker if it sleeps.
+    void Dispatch(Connection& connection, FrameSlot* slot) {
+        Worker& worker = connection.worker;
+        worker.frames.Push(slot);
+        if (worker.sleeping.load()) {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.wake.notify_one();
+        }
+    }
+
+    /// @brief Executes queued frames until `Stop`. An idle worker spins briefly, then sleeps until woken.
+    void WorkerLoop(Worker& worker) {
+        unsigned idle = 0;
+        while (true) {
+            FrameSlot* slot = worker.frames.Pop();
+            if (!slot) {
+                if (idle < 64) {
+                    idle++;
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (workersStopping) {
+                    return; // Every I/O thread has ended, nothing more can arrive
+                }
+
+                worker.sleeping = true;
+                {
+                    std::unique_lock<std::mutex> lock(worker.mutex);
+                    slot = worker.frames.Pop();
+                    if (!slot && !workersStopping) {
+                        // The timeout covers a frame whose push was still in progress while we looked
+                        worker.wake.wait_for(lock, std::chrono::milliseconds(1));
+                    }
+                }
+                worker.sleeping = false;
+                if (!slot) {
+                    continue;
+                }
+            }
+
+            idle = 0;
+            Execute(*slot);
+        }
+    }
+
+    /// @brief Executes one frame with the connection's executor and returns the slot to its I/O thread.
+    void Execute(FrameSlot& slot) {
+        Connection& connection = *slot.connection;
+        connection.session.Reset(slot.data, slot.size);
+        connection.executor.Tick(Timeout::Milliseconds(WriteTimeoutMs));
+        connection.free.TryPush(&slot);
+        framesServed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
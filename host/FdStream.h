@@ -0,0 +1,222 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+#include "IStream.h"
+
+/// @brief Converts the time left on a timeout to a `poll` timeout.
+inline int PollMilliseconds(const Timeout& timeout) {
+    uint64_t remaining = timeout.RemainingMilliseconds();
+    return remaining < INT_MAX ? static_cast<int>(remaining) : INT_MAX;
+}
+
+/// @brief An `IStream` over a POSIX file descriptor: a socket, a pipe or a serial port.
+/// The descriptor is switched to non-blocking mode and waits are done with `poll`, so reads and
+/// writes honour their timeout. Once the peer has closed the connection `Closed` returns true
+/// and reads return 0 at once. One thread may read while another writes.
+class FdStream : public IStream {
+    int fd;              ///< The file descriptor.
+    bool owned;          ///< Close `fd` on destruction.
+    std::atomic<bool> closed{false}; ///< Set when the peer closed the connection or the descriptor failed.
+
+public:
+    /// @brief Constructs a stream over an open file descriptor.
+    /// @param descriptor The file descriptor.
+    /// @param own True to close the descriptor when the stream is destroyed.
+    explicit FdStream(int descriptor, bool own = false) : fd(descriptor), owned(own) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    ~FdStream() {
+        if (owned) {
+            close(fd);
+        }
+    }
+
+    FdStream(const FdStream&) = delete;
+    FdStream& operator=(const FdStream&) = delete;
+
+    /// @brief Returns the file descriptor.
+    int Fd() const { return fd; }
+
+    /// @brief Returns true once the peer has closed the connection or the descriptor failed.
+    bool Closed() const { return closed; }
+
+    /// @brief Reads whatever is available, waiting up to `timeout` for the first byte.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        while (!closed) {
+            ssize_t count = read(fd, data, size);
+            if (count > 0) {
+                return static_cast<size_t>(count);
+            }
+            if (count == 0 || (errno != EAGAIN && errno != EINTR)) {
+                closed = true;
+                break;
+            }
+            if (!Wait(POLLIN, timeout)) {
+                break;
+            }
+        }
+        return 0;
+    }
+
+    /// @brief Writes all of `data` unless the timeout expires first.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        size_t written = 0;
+        while (written < size && !closed) {
+            ssize_t count = send(fd, bytes + written, size - written, MSG_NOSIGNAL);
+            if (count < 0 && errno == ENOTSOCK) {
+                count = write(fd, bytes + written, size - written);
+            }
+            if (count > 0) {
+                written += static_cast<size_t>(count);
+                continue;
+            }
+            if (count < 0 && errno != EAGAIN && errno != EINTR) {
+                closed = true;
+                break;
+            }
+            if (!Wait(POLLOUT, timeout)) {
+                break;
+            }
+        }
+        return written;
+    }
+
+    /// @brief Writes are handed to the kernel at once, there is nothing to flush.
+    virtual void Flush(const Timeout& timeout) override {}
+
+private:
+    /// @brief Waits for the descriptor to become ready for `events`.
+    /// @return False if the timeout expired first.
+    bool Wait(short events, const Timeout& timeout) {
+        pollfd entry{fd, events, 0};
+        int ready = poll(&entry, 1, PollMilliseconds(timeout));
+        if (ready > 0 && (entry.revents & (POLLERR | POLLNVAL))) {
+            closed = true;
+        }
+        return ready > 0 || (ready < 0 && errno == EINTR && !timeout.Expired());
+    }
+};
+
+/// @brief Opens a serial port in raw 8N1 mode.
+/// @param path The device, e.g. "/dev/ttyUSB0".
+/// @param baud The baud rate; one of the standard rates from 9600 to 921600.
+/// @return The file descriptor, or -1 on failure.
+inline int OpenSerialPort(const char* path, uint32_t baud) {
+    speed_t speed;
+    switch (baud) {
+    case 9600: speed = B9600; break;
+    case 19200: speed = B19200; break;
+    case 38400: speed = B38400; break;
+    case 57600: speed = B57600; break;
+    case 115200: speed = B115200; break;
+    case 230400: speed = B230400; break;
+    case 460800: speed = B460800; break;
+    case 921600: speed = B921600; break;
+    default: return -1;
+    }
+
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return -1;
+    }
+
+    termios settings;
+    if (tcgetattr(fd, &settings) != 0) {
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&settings);
+    settings.c_cflag |= CLOCAL | CREAD;
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+    if (tcsetattr(fd, TCSANOW, &settings) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Creates a Unix domain socket listening at `path`, replacing any stale socket file.
+/// @return The listening socket, or -1 on failure.
+inline int ListenUnix(const char* path) {
+    sockaddr_un address{};
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Creates a TCP socket listening on `port`.
+/// @param port The port, or 0 to let the system pick one; see `ListeningPort`.
+/// @param loopbackOnly True to accept connections from this machine only.
+/// @return The listening socket, or -1 on failure.
+inline int ListenTcp(uint16_t port, bool loopbackOnly = false) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Returns the port a TCP socket is bound to, or 0 on failure.
+inline uint16_t ListeningPort(int fd) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+/// @brief Waits up to `timeout` for a connection on a listening socket and accepts it.
+/// TCP connections get `TCP_NODELAY`, as responses are small and latency bound.
+/// @return The connected socket, or -1 if none arrived in time.
+inline int AcceptConnection(int listenFd, const Timeout& timeout) {
+    pollfd entry{listenFd, POLLIN, 0};
+    if (poll(&entry, 1, PollMilliseconds(timeout)) <= 0) {
+        return -1;
+    }
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0) {
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Fails harmlessly on Unix sockets
+    }
+    return fd;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "IStream.h"
+
+/// @brief An in-memory `IStream` for host builds and benchmarks.
+/// Bytes injected with `Feed` are returned by `Read`, bytes passed to `Write` are collected
+/// and can be inspected with `Written`. `Loop` moves the written bytes back to the read side,
+/// so a serializer can read back exactly what it produced.
+/// Reads never block: when no data is queued `Read` returns 0 immediately.
+class LoopbackStream : public IStream {
+    std::vector<uint8_t> rx;  ///< Bytes queued for reading.
+    size_t rxPos = 0;         ///< Read position within `rx`.
+    std::vector<uint8_t> tx;  ///< Bytes written to the stream.
+    size_t writeCalls = 0;    ///< Number of `Write` calls since the last `ClearWritten`.
+
+public:
+    /// @brief Queues bytes to be returned by subsequent reads.
+    /// @param data A pointer to the bytes to queue.
+    /// @param size The number of bytes to queue.
+    void Feed(const void* data, size_t size) {
+        if (rxPos == rx.size()) {
+            rx.clear();
+            rxPos = 0;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        rx.insert(rx.end(), bytes, bytes + size);
+    }
+
+    /// @brief Queues a null-terminated string (without the terminator) to be returned by subsequent reads.
+    void Feed(const char* text) { Feed(text, strlen(text)); }
+
+    /// @brief Makes the queued bytes readable again from the start of the queue.
+    /// Benchmarks use this to replay the same input without copying it on every iteration.
+    void Rewind() { rxPos = 0; }
+
+    /// @brief Moves all written bytes to the read side of the stream.
+    void Loop() {
+        Feed(tx.data(), tx.size());
+        tx.clear();
+    }
+
+    /// @brief Returns the number of bytes that can still be read.
+    size_t Available() const { return rx.size() - rxPos; }
+
+    /// @brief Returns all bytes written since the last `ClearWritten`.
+    const std::vector<uint8_t>& Written() const { return tx; }
+
+    /// @brief Returns the number of `Write` calls since the last `ClearWritten`.
+    /// On a real transport each of these would be a separate syscall or UART fill.
+    size_t WriteCalls() const { return writeCalls; }
+
+    /// @brief Discards the collected written bytes and resets the write call counter.
+    void ClearWritten() {
+        tx.clear();
+        writeCalls = 0;
+    }
+
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        size_t count = size < Available() ? size : Available();
+        if (count) {
+            memcpy(data, rx.data() + rxPos, count);
+            rxPos += count;
+        }
+        return count;
+    }
+
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        tx.insert(tx.end(), bytes, bytes + size);
+        writeCalls++;
+        return size;
+    }
+
+    virtual void Flush(const Timeout& timeout) override {}
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+#include "IStream.h"
+
+/// @brief The impairments of a simulated serial link.
+struct LinkModel {
+    uint32_t baud = 0;            ///< Line rate in bits per second, 10 bits per byte as on a UART; 0 for unlimited.
+    uint32_t latencyUs = 0;       ///< Propagation delay added to every byte, in microseconds.
+    double lossRate = 0;          ///< Probability that a byte is dropped.
+    double bitErrorRate = 0;      ///< Probability that a bit of a delivered byte is flipped.
+    uint32_t seed = 1;            ///< Seed of the impairment generator, runs with the same seed are repeatable.
+};
+
+/// @brief An `IStream` decorator that sends written bytes through a simulated impaired link.
+/// Each written byte occupies the line for one byte time at `baud`, then arrives `latencyUs`
+/// later, unless it is dropped or has bits flipped on the way. Bytes reach the base stream once
+/// they are due, on any later call into this stream, so both ends of a simulated link must keep
+/// calling into their stream, as they do while waiting for data. Writes never block; the line
+/// rate shows up as delay. Reads are passed through from the base stream unchanged.
+///
+/// Typically each end of a socketpair gets its own `LossyStream`, one per direction of the link.
+class LossyStream : public IStream {
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief A byte on its way through the link.
+    struct InFlight {
+        uint64_t dueUs;  ///< When the byte reaches the base stream.
+        uint8_t byte;
+    };
+
+    IStream& baseStream;
+    LinkModel model;
+    std::mt19937 random;
+    std::uniform_real_distribution<double> chance{0.0, 1.0};
+    double byteUs;                 ///< Line time of one byte in microseconds.
+    double lineFreeUs = 0;         ///< When the line has sent every byte written so far.
+    std::deque<InFlight> inFlight; ///< Written bytes not delivered yet, oldest first.
+    std::vector<uint8_t> due;      ///< Scratch buffer collecting the bytes delivered in one go.
+    Clock::time_point epoch = Clock::now();
+
+    uint64_t bytesWritten = 0;
+    uint64_t bytesDropped = 0;
+    uint64_t bitsFlipped = 0;
+
+public:
+    /// @brief Constructs a simulated link in front of a base stream.
+    /// @param stream The stream delivered bytes are written to and reads are taken from.
+    /// @param link The impairments of the link.
+    LossyStream(IStream& stream, const LinkModel& link)
+        : baseStream(stream), model(link), random(link.seed), byteUs(link.baud ? 10e6 / link.baud : 0) {}
+
+    /// @brief Queues bytes on the link. All bytes are accepted; dropped ones count as written.
+    virtual size_t Write(const void* data, size_t size, const Timeout& timeout) override {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        double now = static_cast<double>(NowUs());
+        if (lineFreeUs < now) {
+            lineFreeUs = now;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            lineFreeUs += byteUs;
+            bytesWritten++;
+            if (model.lossRate > 0 && chance(random) < model.lossRate) {
+                bytesDropped++;
+                continue;
+            }
+            uint8_t byte = bytes[i];
+            if (model.bitErrorRate > 0) {
+                for (int bit = 0; bit < 8; ++bit) {
+                    if (chance(random) < model.bitErrorRate) {
+                        byte ^= static_cast<uint8_t>(1u << bit);
+                        bitsFlipped++;
+                    }
+                }
+            }
+            inFlight.push_back(InFlight{static_cast<uint64_t>(lineFreeUs) + model.latencyUs, byte});
+        }
+        Deliver();
+        return size;
+    }
+
+    /// @brief Delivers due bytes, then reads from the base stream.
+    /// While waiting for data, bytes of this end keep being delivered as they fall due.
+    virtual size_t Read(void* data, size_t size, const Timeout& timeout) override {
+        while (true) {
+            Deliver();
+            if (inFlight.empty()) {
+                return baseStream.Read(data, size, timeout);
+            }
+            size_t count = baseStream.Read(data, size, Timeout::Milliseconds(0));
+            if (count || timeout.Expired()) {
+                return count;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    /// @brief Delivers due bytes and flushes the base stream. Bytes still on the line stay there.
+    virtual void Flush(const Timeout& timeout) override {
+        Deliver();
+        baseStream.Flush(timeout);
+    }
+
+    /// @brief Writes every byte that has arrived by now to the base stream.
+    void Deliver() {
+        if (inFlight.empty()) {
+            return;
+        }
+        uint64_t now = NowUs();
+        due.clear();
+        while (!inFlight.empty() && inFlight.front().dueUs <= now) {
+            due.push_back(inFlight.front().byte);
+            inFlight.pop_front();
+        }
+        if (!due.empty()) {
+            baseStream.Write(due.data(), due.size(), Timeout::Milliseconds(0));
+        }
+    }
+
+    /// @brief Returns the number of bytes still on the line.
+    size_t InFlightBytes() const { return inFlight.size(); }
+
+    /// @brief Returns the number of bytes written, including dropped ones.
+    uint64_t BytesWritten() const { return bytesWritten; }
+
+    /// @brief Returns the number of bytes the link dropped.
+    uint64_t BytesDropped() const { return bytesDropped; }
+
+    /// @brief Returns the number of bits the link flipped.
+    uint64_t BitsFlipped() const { return bitsFlipped; }
+
+private:
+    uint64_t NowUs() const {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count());
+    }
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+
+/// @brief The link embedded in elements of an `MpscQueue`.
+struct MpscNode {
+    std::atomic<MpscNode*> next{nullptr};
+};
+
+/// @brief An unbounded lock-free queue for any number of producer threads and one consumer thread.
+/// The queue is intrusive: elements derive from `MpscNode` and are linked in place, so pushing
+/// never allocates. A push is one atomic exchange and cannot fail or wait. A pop can briefly see
+/// the queue as empty while a producer is between its two steps; the element is then returned
+/// by a later pop.
+/// @tparam T The element type, derived from `MpscNode`. Elements must outlive their time in the queue.
+template <typename T>
+class MpscQueue {
+    alignas(64) std::atomic<MpscNode*> head; ///< The most recently pushed node, written by producers.
+    alignas(64) MpscNode* tail;              ///< The oldest node, only used by the consumer.
+    MpscNode stub;                           ///< Placeholder node that keeps the list non-empty.
+
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// @brief Appends an element. Safe to call from any thread.
+    void Push(T* item) {
+        PushNode(item);
+    }
+
+    /// @brief Removes the oldest element. Only call from the consumer thread.
+    /// @return The element, or nullptr if the queue is empty or its next element is not linked yet.
+    T* Pop() {
+        MpscNode* first = tail;
+        MpscNode* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (!next) {
+                return nullptr;
+            }
+            tail = next; // Skip the placeholder
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail = next;
+            return static_cast<T*>(first);
+        }
+
+        if (first != head.load(std::memory_order_acquire)) {
+            return nullptr; // A producer has swapped the head but not linked its node yet
+        }
+
+        // `first` is the last node; put the placeholder behind it so it can be unlinked
+        PushNode(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return static_cast<T*>(first);
+        }
+        return nullptr;
+    }
+
+private:
+    void PushNode(MpscNode* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+};
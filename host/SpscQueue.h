@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/// @brief A bounded lock-free queue for exactly one producer thread and one consumer thread.
+/// Elements live in a fixed ring; the producer only writes `tail` and the consumer only writes
+/// `head`, so neither side ever waits for the other or takes a lock. Both indexes count up
+/// without wrapping the ring, which lets the queue hold all `N` elements.
+/// @tparam T The element type, copied in and out of the ring.
+/// @tparam N The capacity, a power of two.
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    alignas(64) std::atomic<size_t> head{0}; ///< Next element to pop, written by the consumer.
+    alignas(64) std::atomic<size_t> tail{0}; ///< Next free element, written by the producer.
+    alignas(64) T ring[N];                   ///< The elements in [head, tail), indexed modulo N.
+
+public:
+    /// @brief Appends an element. Only call from the producer thread.
+    /// @return False if the queue is full.
+    bool TryPush(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        ring[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Removes the oldest element. Only call from the consumer thread.
+    /// @return False if the queue is empty.
+    bool TryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = ring[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Returns the number of queued elements; only a snapshot while the other side is active.
+    size_t Size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};